@@ -0,0 +1,23 @@
+#!/bin/bash
+
+## =================================================================
+## PAGE SIZE BENCHMARK
+##
+## Builds BusTub once per supported page size, each in its own
+## build directory, and runs the table scan benchmark of each build.
+##
+## Usage: build_support/page_size_benchmark.sh [build directory prefix]
+## =================================================================
+
+set -o errexit
+
+SOURCE_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_PREFIX="${1:-${SOURCE_DIR}/build-page-size}"
+
+for page_size in 4096 8192 16384 32768; do
+  build_dir="${BUILD_PREFIX}-${page_size}"
+  cmake -S "${SOURCE_DIR}" -B "${build_dir}" -DCMAKE_BUILD_TYPE=Release -DBUSTUB_PAGE_SIZE=${page_size} > /dev/null
+  cmake --build "${build_dir}" --target table_heap_test -j"$(nproc)" > /dev/null
+  (cd "${build_dir}" && ./test/table_heap_test --gtest_also_run_disabled_tests \
+    --gtest_filter=TableHeapTest.DISABLED_ScanBenchmarkTest | grep "^PAGE_SIZE")
+done
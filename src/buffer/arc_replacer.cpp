@@ -0,0 +1,208 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+bool ARCReplacer::GhostList::Remove(page_id_t page_id) {
+  auto iter = index_.find(page_id);
+  if (iter == index_.end()) {
+    return false;
+  }
+  pages_.erase(iter->second);
+  index_.erase(iter);
+  return true;
+}
+
+void ARCReplacer::GhostList::Push(page_id_t page_id) {
+  Remove(page_id);
+  index_[page_id] = pages_.insert(pages_.end(), page_id);
+}
+
+void ARCReplacer::GhostList::PopOldest() {
+  index_.erase(pages_.front());
+  pages_.pop_front();
+}
+
+ARCReplacer::ARCReplacer(size_t num_pages) : capacity_(num_pages) { frames_.reserve(num_pages); }
+
+ARCReplacer::~ARCReplacer() = default;
+
+ARCReplacer::FrameState *ARCReplacer::Track(frame_id_t frame_id, bool in_t2, page_id_t page_id) {
+  FrameState &state = frames_[frame_id];
+  state.in_t2_ = in_t2;
+  state.evictable_ = false;
+  state.accessed_ = false;
+  state.page_id_ = page_id;
+  if (in_t2) {
+    t2_resident_++;
+  } else {
+    t1_resident_++;
+  }
+  return &state;
+}
+
+void ARCReplacer::Detach(frame_id_t frame_id, FrameState *state) {
+  if (state->in_t2_) {
+    t2_.erase({state->seq_, frame_id});
+  } else {
+    t1_.erase({state->seq_, frame_id});
+  }
+  state->evictable_ = false;
+}
+
+void ARCReplacer::Forget(frame_id_t frame_id) {
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    return;
+  }
+  if (iter->second.evictable_) {
+    Detach(frame_id, &iter->second);
+  }
+  if (iter->second.in_t2_) {
+    t2_resident_--;
+  } else {
+    t1_resident_--;
+  }
+  frames_.erase(iter);
+}
+
+void ARCReplacer::TrimGhosts() {
+  // |T1| + |B1| <= c keeps B1 from remembering scans forever, |T1| + |T2| + |B1| + |B2| <= 2c bounds the directory.
+  while (b1_.Size() > 0 && t1_resident_ + b1_.Size() > capacity_) {
+    b1_.PopOldest();
+  }
+  while (t1_resident_ + t2_resident_ + b1_.Size() + b2_.Size() > 2 * capacity_) {
+    if (b2_.Size() > 0) {
+      b2_.PopOldest();
+    } else if (b1_.Size() > 0) {
+      b1_.PopOldest();
+    } else {
+      break;
+    }
+  }
+}
+
+bool ARCReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  bool from_t1;
+  if (!t1_.empty() && (t1_resident_ > target_t1_ || t2_.empty())) {
+    from_t1 = true;
+    *frame_id = t1_.begin()->second;
+  } else if (!t2_.empty()) {
+    from_t1 = false;
+    *frame_id = t2_.begin()->second;
+  } else {
+    return false;
+  }
+  page_id_t page_id = frames_[*frame_id].page_id_;
+  Forget(*frame_id);
+  if (page_id != INVALID_PAGE_ID) {
+    (from_t1 ? b1_ : b2_).Push(page_id);
+    TrimGhosts();
+  }
+  return true;
+}
+
+void ARCReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end() || !iter->second.evictable_) {
+    return;
+  }
+  Detach(frame_id, &iter->second);
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  FrameState *state = iter == frames_.end() ? Track(frame_id, false, INVALID_PAGE_ID) : &iter->second;
+  if (state->evictable_) {
+    Detach(frame_id, state);
+  }
+  // Any access after the one that loaded the page makes it frequent.
+  if (state->accessed_ && !state->in_t2_) {
+    state->in_t2_ = true;
+    t1_resident_--;
+    t2_resident_++;
+  }
+  state->accessed_ = true;
+  state->seq_ = ++current_timestamp_;
+  (state->in_t2_ ? t2_ : t1_).emplace(state->seq_, frame_id);
+  state->evictable_ = true;
+}
+
+void ARCReplacer::UnpinPrefetched(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  FrameState *state = iter == frames_.end() ? Track(frame_id, false, INVALID_PAGE_ID) : &iter->second;
+  if (state->evictable_) {
+    return;
+  }
+  // The frame stays in the list SetPage put it in, and the fetch that follows is the access that loaded the page.
+  state->seq_ = ++current_timestamp_;
+  (state->in_t2_ ? t2_ : t1_).emplace(state->seq_, frame_id);
+  state->evictable_ = true;
+}
+
+void ARCReplacer::SetPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  Forget(frame_id);
+  // A ghost hit means the list the page was evicted from should have been larger.
+  bool in_t2 = false;
+  if (b1_.Remove(page_id)) {
+    size_t delta = std::max<size_t>(b2_.Size() / std::max<size_t>(b1_.Size(), 1), 1);
+    target_t1_ = std::min(capacity_, target_t1_ + delta);
+    in_t2 = true;
+  } else if (b2_.Remove(page_id)) {
+    size_t delta = std::max<size_t>(b1_.Size() / std::max<size_t>(b2_.Size(), 1), 1);
+    target_t1_ -= std::min(target_t1_, delta);
+    in_t2 = true;
+  }
+  Track(frame_id, in_t2, page_id);
+  TrimGhosts();
+}
+
+std::vector<frame_id_t> ARCReplacer::PeekVictims(size_t max_frames) {
+  std::scoped_lock lock{latch_};
+  // Replay the choices Victim would make, without the ghost hits that would move the target in between.
+  std::vector<frame_id_t> frames;
+  size_t t1_resident = t1_resident_;
+  auto t1_iter = t1_.begin();
+  auto t2_iter = t2_.begin();
+  while (frames.size() < max_frames) {
+    if (t1_iter != t1_.end() && (t1_resident > target_t1_ || t2_iter == t2_.end())) {
+      frames.push_back((t1_iter++)->second);
+      t1_resident--;
+    } else if (t2_iter != t2_.end()) {
+      frames.push_back((t2_iter++)->second);
+    } else {
+      break;
+    }
+  }
+  return frames;
+}
+
+size_t ARCReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return t1_.size() + t2_.size();
+}
+
+size_t ARCReplacer::GetTargetT1Size() {
+  std::scoped_lock lock{latch_};
+  return target_t1_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,701 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.cpp
+//
+// Identification: src/buffer/buffer_pool_manager_instance.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances,
+                                                     uint32_t instance_index, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      arena_(pool_size, ChooseNumaNode(num_instances, instance_index)),
+      pages_(arena_.GetFrames()),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_table_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "If the instance is not part of a parallel pool, num_instances should be 1.");
+  BUSTUB_ASSERT(instance_index < num_instances, "Instance index must be smaller than the number of instances.");
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size);
+      break;
+    case ReplacerType::TWO_QUEUE:
+      replacer_ = new TwoQueueReplacer(pool_size);
+      break;
+    case ReplacerType::ARC:
+      replacer_ = new ARCReplacer(pool_size);
+      break;
+  }
+
+  // Initially, every page is in the free list. Free frames are locked so that they can never be pinned.
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].pin_count_ = FRAME_LOCKED;
+    free_list_.emplace_back(static_cast<int>(i));
+  }
+  registered_buffer_ = disk_manager_->RegisterBuffer(arena_.GetData(), arena_.GetDataSize());
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopPageCleaner();
+  if (prefetch_thread_.joinable()) {
+    {
+      std::scoped_lock prefetch_lock{prefetch_latch_};
+      prefetch_shutdown_ = true;
+    }
+    prefetch_cv_.notify_one();
+    prefetch_thread_.join();
+  }
+  if (registered_buffer_) {
+    disk_manager_->UnregisterBuffer(arena_.GetData());
+  }
+  delete replacer_;
+}
+
+bool BufferPoolManagerInstance::FindFreeFrame(std::unique_lock<std::mutex> *lock, frame_id_t *frame_id,
+                                              bool *waited) {
+  // Pages are always found from the free list first.
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  while (replacer_->Victim(frame_id)) {
+    Page *victim = &pages_[*frame_id];
+    int expected = 0;
+    while (!victim->pin_count_.compare_exchange_strong(expected, FRAME_LOCKED) && expected == FRAME_LOCKED) {
+      // The page cleaner is writing the victim back, which is about to make it the cheapest frame to reuse.
+      frame_unlocked_.wait(*lock);
+      if (waited != nullptr) {
+        *waited = true;
+      }
+      expected = 0;
+    }
+    if (expected != 0) {
+      // The frame was pinned without the latch after it was unpinned. It is handed back to the replacer when its pin
+      // count drops to 0 again.
+      continue;
+    }
+    EvictPage(lock, victim, waited);
+    return true;
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::ReturnFreeFrame(frame_id_t frame_id) {
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  free_list_.emplace_back(frame_id);
+}
+
+bool BufferPoolManagerInstance::FindRingFrame(std::unique_lock<std::mutex> *lock, BufferRing *ring,
+                                              frame_id_t *frame_id, bool *waited) {
+  if (ring->pages_.size() < ring->capacity_) {
+    return false;
+  }
+  // In a parallel buffer pool the ring holds pages of every instance, recycle the oldest one that belongs to us.
+  auto iter = std::find_if(ring->pages_.begin(), ring->pages_.end(), [&](page_id_t page_id) {
+    return static_cast<uint32_t>(page_id) % num_instances_ == instance_index_;
+  });
+  if (iter == ring->pages_.end()) {
+    return false;
+  }
+  page_id_t page_id = *iter;
+  ring->pages_.erase(iter);
+  if (!page_table_.Find(page_id, frame_id)) {
+    return false;
+  }
+  // A page that is pinned by someone else is left to them and to the replacer.
+  Page *page = &pages_[*frame_id];
+  int expected = 0;
+  if (!page->pin_count_.compare_exchange_strong(expected, FRAME_LOCKED)) {
+    return false;
+  }
+  replacer_->Pin(*frame_id);
+  EvictPage(lock, page, waited);
+  return true;
+}
+
+void BufferPoolManagerInstance::EvictPage(std::unique_lock<std::mutex> *lock, Page *page, bool *waited) {
+  // If the victim is dirty, write it back to the disk before reusing its frame. The page cleaner should have done it.
+  // The frame is locked, so nobody can pin the page and change it while the latch is released for the write.
+  bool written = false;
+  if (page->is_dirty_) {
+    page->is_dirty_ = false;
+    lock->unlock();
+    disk_manager_->WritePage(page->page_id_, page->GetData());
+    lock->lock();
+    written = true;
+    num_sync_eviction_writes_++;
+    cleaner_cv_.notify_one();
+    if (waited != nullptr) {
+      *waited = true;
+    }
+  }
+  page_table_.Remove(page->page_id_);
+  UnmapFrame(page);
+  if (written) {
+    // Fetchers of the page that waited for the write now read it back from the disk.
+    frame_unlocked_.notify_all();
+  }
+}
+
+Page *BufferPoolManagerInstance::TryPinFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_.load();
+  while (pin_count >= 0) {
+    if (page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1)) {
+      // The frame cannot be reassigned while we hold a pin, so its page id is now stable.
+      if (page->page_id_ == page_id) {
+        return page;
+      }
+      ReleaseFrame(frame_id);
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+void BufferPoolManagerInstance::ReleaseFrame(frame_id_t frame_id) {
+  if (pages_[frame_id].pin_count_.fetch_sub(1) == 1) {
+    MakeEvictable(frame_id);
+  }
+}
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id) { return FetchPageImpl(page_id, nullptr); }
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id, BufferRing *ring) {
+  if (ring != nullptr && !ring->RecordFetch(page_id)) {
+    ring = nullptr;
+  }
+
+  // Fast path: if the page is resident, pin it without taking the latch.
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    Page *page = TryPinFrame(frame_id, page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+
+  std::unique_lock lock{latch_};
+  // The page may have been loaded or moved while we were looking it up. Once a read ahead of it has finished, a mapped
+  // frame is unlocked under the latch, so the pin cannot fail.
+  if (FindReadFrame(&lock, page_id, &frame_id)) {
+    Page *page = TryPinFrame(frame_id, page_id);
+    BUSTUB_ASSERT(page != nullptr, "A mapped frame must be pinnable under the latch.");
+    return page;
+  }
+
+  // Otherwise find a replacement frame and read the page in from disk.
+  bool waited = false;
+  if ((ring == nullptr || !FindRingFrame(&lock, ring, &frame_id, &waited)) &&
+      !FindFreeFrame(&lock, &frame_id, &waited)) {
+    return nullptr;
+  }
+  // Someone else may have read the page in while we waited for the frame, use their copy then.
+  frame_id_t resident_frame_id;
+  if (waited && FindReadFrame(&lock, page_id, &resident_frame_id)) {
+    ReturnFreeFrame(frame_id);
+    Page *page = TryPinFrame(resident_frame_id, page_id);
+    BUSTUB_ASSERT(page != nullptr, "A mapped frame must be pinnable under the latch.");
+    return page;
+  }
+  // Like a read ahead, read the page while its frame is locked and the latch is released: fetchers of the page wait for
+  // the read, everyone else goes on using the pool.
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  page_table_.Insert(page_id, frame_id);
+  lock.unlock();
+
+  CancelPrefetch(page_id);
+  if (!MapFrame(page)) {
+    disk_manager_->ReadPage(page_id, page->GetData());
+  }
+  if (ring != nullptr) {
+    ring->AddPage(page_id);
+  }
+
+  lock.lock();
+  replacer_->SetPage(frame_id, page_id);
+  // Publishing the pin count unlocks the frame for optimistic pins.
+  page->pin_count_ = 1;
+  lock.unlock();
+  frame_unlocked_.notify_all();
+  return page;
+}
+
+size_t BufferPoolManagerInstance::FetchPagesImpl(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) {
+  pages->assign(page_ids.size(), nullptr);
+  size_t num_fetched = 0;
+
+  // Fast path: pin the resident pages without taking the latch.
+  std::vector<size_t> misses;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    frame_id_t frame_id;
+    if (page_table_.Find(page_ids[i], &frame_id) && ((*pages)[i] = TryPinFrame(frame_id, page_ids[i])) != nullptr) {
+      num_fetched++;
+    } else {
+      misses.push_back(i);
+    }
+  }
+  if (misses.empty()) {
+    return num_fetched;
+  }
+
+  // Claim and map a frame for every missing page in page id order, without reading it yet. A batch only ever waits for
+  // pages above the ones it has claimed, so two batches cannot wait for each other.
+  std::stable_sort(misses.begin(), misses.end(), [&page_ids](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+  // The claimed frames in page id order, with the number of times their page was requested.
+  std::vector<std::pair<frame_id_t, int>> reads;
+  std::unique_lock lock{latch_};
+  for (size_t pos = 0; pos < misses.size();) {
+    page_id_t page_id = page_ids[misses[pos]];
+    size_t end = pos;
+    while (end < misses.size() && page_ids[misses[end]] == page_id) {
+      end++;
+    }
+    frame_id_t frame_id;
+    if (FindReadFrame(&lock, page_id, &frame_id)) {
+      // The page was read in since we looked it up.
+      for (; pos < end; pos++) {
+        (*pages)[misses[pos]] = TryPinFrame(frame_id, page_id);
+        BUSTUB_ASSERT((*pages)[misses[pos]] != nullptr, "A mapped frame must be pinnable under the latch.");
+        num_fetched++;
+      }
+      continue;
+    }
+    bool waited = false;
+    if (!FindFreeFrame(&lock, &frame_id, &waited)) {
+      break;
+    }
+    frame_id_t resident_frame_id;
+    if (waited && FindReadFrame(&lock, page_id, &resident_frame_id)) {
+      // The page was read in while we waited for the frame.
+      ReturnFreeFrame(frame_id);
+      for (; pos < end; pos++) {
+        (*pages)[misses[pos]] = TryPinFrame(resident_frame_id, page_id);
+        BUSTUB_ASSERT((*pages)[misses[pos]] != nullptr, "A mapped frame must be pinnable under the latch.");
+        num_fetched++;
+      }
+      continue;
+    }
+    Page *page = &pages_[frame_id];
+    page->page_id_ = page_id;
+    page->is_dirty_ = false;
+    page_table_.Insert(page_id, frame_id);
+    reads.emplace_back(frame_id, end - pos);
+    for (; pos < end; pos++) {
+      (*pages)[misses[pos]] = page;
+    }
+  }
+  lock.unlock();
+
+  // The frames are locked, so fetchers of these pages wait for the reads. Read each run of consecutive pages at once.
+  std::vector<Page *> unmapped;
+  for (const auto &read : reads) {
+    if (!MapFrame(&pages_[read.first])) {
+      unmapped.push_back(&pages_[read.first]);
+    }
+  }
+  for (size_t first = 0; first < unmapped.size();) {
+    std::vector<char *> page_data{unmapped[first]->GetData()};
+    size_t last = first + 1;
+    while (last < unmapped.size() && unmapped[last]->page_id_ == unmapped[last - 1]->page_id_ + 1) {
+      page_data.push_back(unmapped[last++]->GetData());
+    }
+    disk_manager_->ReadPages(unmapped[first]->page_id_, page_data);
+    first = last;
+  }
+
+  lock.lock();
+  for (auto [frame_id, num_requests] : reads) {
+    replacer_->SetPage(frame_id, pages_[frame_id].page_id_);
+    pages_[frame_id].pin_count_ = num_requests;
+    num_fetched += num_requests;
+  }
+  lock.unlock();
+  frame_unlocked_.notify_all();
+  return num_fetched;
+}
+
+bool BufferPoolManagerInstance::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].page_id_ != page_id) {
+    // The lock-free lookup can miss a page whose entry is being moved, so confirm under the latch.
+    std::scoped_lock lock{latch_};
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_.load();
+  if (pin_count <= 0) {
+    return false;
+  }
+  // The dirty flag has to be set before our pin is dropped, otherwise the frame could be evicted in between and the
+  // write would be lost.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  if (pin_count == 1) {
+    MakeEvictable(frame_id);
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::FlushPageImpl(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  std::unique_lock lock{latch_};
+  frame_id_t frame_id;
+  if (!FindReadFrame(&lock, page_id, &frame_id)) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+  // The page may be pinned and unpinned dirty by others meanwhile, without the latch. Clear the flag before the write,
+  // so that such an unpin sets it again rather than being wiped by us.
+  page->is_dirty_ = false;
+  disk_manager_->WritePage(page_id, page->GetData());
+  return true;
+}
+
+Page *BufferPoolManagerInstance::NewPageImpl(page_id_t *page_id) {
+  std::unique_lock lock{latch_};
+  // If all the pages in the buffer pool are pinned, there is nothing we can do.
+  frame_id_t frame_id;
+  if (!FindFreeFrame(&lock, &frame_id)) {
+    *page_id = INVALID_PAGE_ID;
+    return nullptr;
+  }
+  *page_id = AllocatePage();
+  if (*page_id == INVALID_PAGE_ID) {
+    // The data files are full, the frame stays free.
+    ReturnFreeFrame(frame_id);
+    return nullptr;
+  }
+  return InitNewPage(frame_id, *page_id);
+}
+
+Page *BufferPoolManagerInstance::CreatePageImpl(page_id_t page_id) {
+  ValidatePageId(page_id);
+  std::unique_lock lock{latch_};
+  frame_id_t frame_id;
+  if (!FindFreeFrame(&lock, &frame_id)) {
+    return nullptr;
+  }
+  return InitNewPage(frame_id, page_id);
+}
+
+Page *BufferPoolManagerInstance::InitNewPage(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  page->ResetMemory();
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  replacer_->SetPage(frame_id, page_id);
+  page_table_.Insert(page_id, frame_id);
+  page->pin_count_ = 1;
+  return page;
+}
+
+bool BufferPoolManagerInstance::DeletePageImpl(page_id_t page_id) {
+  std::unique_lock lock{latch_};
+  frame_id_t frame_id;
+  if (!FindReadFrame(&lock, page_id, &frame_id)) {
+    DeallocatePage(page_id);
+    return true;
+  }
+  Page *page = &pages_[frame_id];
+  // Someone is using the page.
+  int expected = 0;
+  if (!page->pin_count_.compare_exchange_strong(expected, FRAME_LOCKED)) {
+    return false;
+  }
+  DeallocatePage(page_id);
+  page_table_.Remove(page_id);
+  replacer_->Pin(frame_id);
+  UnmapFrame(page);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  free_list_.emplace_back(frame_id);
+  return true;
+}
+
+void BufferPoolManagerInstance::FlushAllPagesImpl() {
+  std::unique_lock lock{latch_};
+  std::vector<page_id_t> locked_pages;
+  // Hand every page to the disk manager as one batch, which writes runs of consecutive pages at once and syncs once.
+  std::vector<std::pair<page_id_t, const char *>> writes;
+  page_table_.ForEach([&](page_id_t page_id, frame_id_t frame_id) {
+    Page *page = &pages_[frame_id];
+    if (page->pin_count_ == FRAME_LOCKED) {
+      locked_pages.push_back(page_id);
+      return;
+    }
+    // Like in FlushPageImpl, the flag is cleared before the write so that a concurrent dirty unpin is not lost.
+    page->is_dirty_ = false;
+    writes.emplace_back(page_id, page->GetData());
+  });
+  disk_manager_->WritePages(std::move(writes));
+  // Locked pages are being read ahead or written back by the page cleaner, wait for them and write them if needed.
+  for (page_id_t page_id : locked_pages) {
+    frame_id_t frame_id;
+    if (FindReadFrame(&lock, page_id, &frame_id) && pages_[frame_id].is_dirty_.exchange(false)) {
+      disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::PrefetchPageImpl(page_id_t page_id) {
+  frame_id_t frame_id;
+  if (page_id == INVALID_PAGE_ID || page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  // The prefetch thread is only started once someone asks for read-ahead.
+  std::call_once(prefetch_started_,
+                 [this] { prefetch_thread_ = std::thread(&BufferPoolManagerInstance::RunPrefetcher, this); });
+  {
+    std::scoped_lock prefetch_lock{prefetch_latch_};
+    // Prefetching is only a hint, drop it rather than fall further behind the reader.
+    if (prefetch_queue_.size() >= static_cast<size_t>(PREFETCH_QUEUE_SIZE)) {
+      return false;
+    }
+    prefetch_queue_.push_back(page_id);
+  }
+  prefetch_cv_.notify_one();
+  return true;
+}
+
+void BufferPoolManagerInstance::RunPrefetcher() {
+  while (true) {
+    page_id_t page_id;
+    {
+      std::unique_lock prefetch_lock{prefetch_latch_};
+      prefetch_cv_.wait(prefetch_lock, [this] { return prefetch_shutdown_ || !prefetch_queue_.empty(); });
+      if (prefetch_shutdown_) {
+        return;
+      }
+      page_id = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+    }
+    ReadAhead(page_id);
+  }
+}
+
+void BufferPoolManagerInstance::ReadAhead(page_id_t page_id) {
+  std::unique_lock lock{latch_};
+  frame_id_t frame_id;
+  bool waited = false;
+  if (page_table_.Find(page_id, &frame_id) || !FindFreeFrame(&lock, &frame_id, &waited)) {
+    return;
+  }
+  frame_id_t resident_frame_id;
+  if (waited && page_table_.Find(page_id, &resident_frame_id)) {
+    // A fetch read the page in while we waited for the frame.
+    ReturnFreeFrame(frame_id);
+    return;
+  }
+  // Map the page while its frame is still locked: fetchers of the page wait for the read instead of issuing their own,
+  // and everyone else can go on using the pool while the page is being read.
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  page_table_.Insert(page_id, frame_id);
+  lock.unlock();
+
+  if (!MapFrame(page)) {
+    disk_manager_->ReadPage(page_id, page->GetData());
+  }
+
+  lock.lock();
+  replacer_->SetPage(frame_id, page_id);
+  page->pin_count_ = 0;
+  // Reading the page ahead is not an access, otherwise the fetch that follows would make a page scanned once look like
+  // a frequently used one.
+  replacer_->UnpinPrefetched(frame_id);
+  num_prefetched_pages_++;
+  lock.unlock();
+  frame_unlocked_.notify_all();
+}
+
+void BufferPoolManagerInstance::CancelPrefetch(page_id_t page_id) {
+  std::scoped_lock prefetch_lock{prefetch_latch_};
+  auto iter = std::find(prefetch_queue_.begin(), prefetch_queue_.end(), page_id);
+  if (iter != prefetch_queue_.end()) {
+    prefetch_queue_.erase(iter);
+  }
+}
+
+bool BufferPoolManagerInstance::FindReadFrame(std::unique_lock<std::mutex> *lock, page_id_t page_id,
+                                              frame_id_t *frame_id) {
+  while (page_table_.Find(page_id, frame_id)) {
+    if (pages_[*frame_id].pin_count_ != FRAME_LOCKED) {
+      return true;
+    }
+    frame_unlocked_.wait(*lock);
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::RunPageCleaner(size_t low_watermark_percent, size_t high_watermark_percent) {
+  BUSTUB_ASSERT(low_watermark_percent <= high_watermark_percent, "The low watermark cannot be above the high one.");
+  std::scoped_lock cleaner_lock{cleaner_latch_};
+  if (cleaner_thread_.joinable()) {
+    return;
+  }
+  cleaner_low_watermark_ = std::max<size_t>(pool_size_ * low_watermark_percent / 100, 1);
+  cleaner_high_watermark_ = std::max<size_t>(pool_size_ * high_watermark_percent / 100, cleaner_low_watermark_);
+  cleaner_shutdown_ = false;
+  cleaner_thread_ = std::thread([this] {
+    std::unique_lock cleaner_lock{cleaner_latch_};
+    while (!cleaner_shutdown_) {
+      cleaner_lock.unlock();
+      CleanPages();
+      cleaner_lock.lock();
+      if (!cleaner_shutdown_) {
+        // An eviction that had to write a dirty page wakes the cleaner up early.
+        cleaner_cv_.wait_for(cleaner_lock, std::chrono::milliseconds(PAGE_CLEANER_INTERVAL));
+      }
+    }
+  });
+}
+
+void BufferPoolManagerInstance::StopPageCleaner() {
+  std::thread cleaner_thread;
+  {
+    std::scoped_lock cleaner_lock{cleaner_latch_};
+    cleaner_shutdown_ = true;
+    cleaner_thread = std::move(cleaner_thread_);
+  }
+  cleaner_cv_.notify_all();
+  if (cleaner_thread.joinable()) {
+    cleaner_thread.join();
+  }
+}
+
+size_t BufferPoolManagerInstance::CleanPages() {
+  size_t free_frames;
+  {
+    std::scoped_lock lock{latch_};
+    free_frames = free_list_.size();
+  }
+  if (free_frames >= cleaner_low_watermark_) {
+    return 0;
+  }
+  // Look at the frames that will be evicted next: once fewer than the low watermark are free or clean, write back the
+  // dirty ones among the first high watermark of them.
+  std::vector<frame_id_t> candidates = replacer_->PeekVictims(cleaner_high_watermark_ - free_frames);
+  size_t ready = free_frames;
+  std::vector<frame_id_t> dirty_frames;
+  for (frame_id_t frame_id : candidates) {
+    if (pages_[frame_id].is_dirty_) {
+      dirty_frames.push_back(frame_id);
+    } else {
+      ready++;
+    }
+  }
+  if (ready >= cleaner_low_watermark_) {
+    return 0;
+  }
+  // Start every write back before waiting for any of them, so that the disk manager can have them in flight at once.
+  std::vector<std::pair<frame_id_t, std::future<bool>>> writes;
+  for (frame_id_t frame_id : dirty_frames) {
+    std::future<bool> write;
+    if (StartWriteBack(frame_id, &write)) {
+      writes.emplace_back(frame_id, std::move(write));
+    }
+  }
+  size_t num_written = 0;
+  for (auto &[frame_id, write] : writes) {
+    bool written = write.get();
+    FinishWriteBack(frame_id, written);
+    if (written) {
+      num_written++;
+      num_cleaner_writes_++;
+    }
+  }
+  return num_written;
+}
+
+bool BufferPoolManagerInstance::StartWriteBack(frame_id_t frame_id, std::future<bool> *write) {
+  // Lock the frame like an eviction would, without taking it out of the replacer. Nobody can pin the page while it is
+  // locked, so its contents and dirty flag cannot change during the write and the pool latch does not need to be held.
+  Page *page = &pages_[frame_id];
+  int expected = 0;
+  if (!page->pin_count_.compare_exchange_strong(expected, FRAME_LOCKED)) {
+    return false;
+  }
+  // Write-ahead logging: a page may only reach the disk after the log records that modified it.
+  if (page->is_dirty_ &&
+      (!enable_logging || log_manager_ == nullptr || page->GetLSN() <= log_manager_->GetPersistentLSN())) {
+    *write = disk_manager_->WritePageAsync(page->page_id_, page->GetData());
+    return true;
+  }
+  FinishWriteBack(frame_id, false);
+  return false;
+}
+
+void BufferPoolManagerInstance::FinishWriteBack(frame_id_t frame_id, bool written) {
+  Page *page = &pages_[frame_id];
+  {
+    std::scoped_lock lock{latch_};
+    if (written) {
+      page->is_dirty_ = false;
+    }
+    page->pin_count_ = 0;
+  }
+  frame_unlocked_.notify_all();
+}
+
+page_id_t BufferPoolManagerInstance::AllocatePage() {
+  const page_id_t next_page_id = disk_manager_->AllocatePage(num_instances_, instance_index_);
+  if (next_page_id != INVALID_PAGE_ID) {
+    ValidatePageId(next_page_id);
+  }
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // Allocated pages must map back to this instance.
+  BUSTUB_ASSERT(static_cast<uint32_t>(page_id) % num_instances_ == instance_index_,
+                "Page id is not owned by this instance.");
+}
+
+}  // namespace bustub
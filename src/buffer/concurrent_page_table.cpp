@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.cpp
+//
+// Identification: src/buffer/concurrent_page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/concurrent_page_table.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ConcurrentPageTable::ConcurrentPageTable(size_t num_frames) : capacity_(2), log_capacity_(1) {
+  // Keep the load factor at or below 1/2 so that probe sequences stay short.
+  while (capacity_ < 2 * num_frames) {
+    capacity_ <<= 1;
+    log_capacity_++;
+  }
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; ++i) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+bool ConcurrentPageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  for (size_t i = HomeSlot(page_id), probes = 0; probes < capacity_; i = (i + 1) & (capacity_ - 1), ++probes) {
+    uint64_t slot = slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (SlotPageId(slot) == page_id) {
+      *frame_id = SlotFrameId(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ConcurrentPageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot map the invalid page id.");
+  size_t i = HomeSlot(page_id);
+  while (true) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT || SlotPageId(slot) == page_id) {
+      if (slot == EMPTY_SLOT) {
+        size_.fetch_add(1, std::memory_order_relaxed);
+      }
+      slots_[i].store(MakeSlot(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+    i = (i + 1) & (capacity_ - 1);
+  }
+}
+
+bool ConcurrentPageTable::Remove(page_id_t page_id) {
+  size_t hole = HomeSlot(page_id);
+  while (true) {
+    uint64_t slot = slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (SlotPageId(slot) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & (capacity_ - 1);
+  }
+
+  // Backward shift deletion: move every later entry of the cluster whose home slot does not lie cyclically in
+  // (hole, i] into the hole, so that no probe sequence is broken by the removal.
+  size_t i = hole;
+  while (true) {
+    i = (i + 1) & (capacity_ - 1);
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeSlot(SlotPageId(slot));
+    bool home_in_range = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+    if (!home_in_range) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = i;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  size_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <new>
+#include <string>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Memory policy that prefers a node but falls back to others, see mbind(2). Not every libc exports numaif.h. */
+constexpr int MPOL_PREFERRED_NODE = 1;
+
+/** Round size up to a multiple of alignment, which must be a power of two. */
+size_t RoundUp(size_t size, size_t alignment) { return (size + alignment - 1) & ~(alignment - 1); }
+
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, int numa_node) : num_frames_(num_frames) {
+  data_size_ = RoundUp(num_frames_ * PAGE_SIZE, static_cast<size_t>(getpagesize()));
+  huge_pages_ = data_size_ >= static_cast<size_t>(HUGE_PAGE_SIZE);
+  if (huge_pages_) {
+    data_size_ = RoundUp(data_size_, HUGE_PAGE_SIZE);
+  }
+
+  // Map an extra huge page, so that the data can start on a huge page boundary, then unmap the excess on both ends.
+  size_t map_size = huge_pages_ ? data_size_ + HUGE_PAGE_SIZE : data_size_;
+  void *map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Couldn't map the frames of the buffer pool.");
+  }
+  data_ = static_cast<char *>(map);
+  if (huge_pages_) {
+    auto start = reinterpret_cast<uintptr_t>(map);
+    data_ = reinterpret_cast<char *>(RoundUp(start, HUGE_PAGE_SIZE));
+    size_t head = data_ - static_cast<char *>(map);
+    if (head > 0) {
+      munmap(map, head);
+    }
+    if (map_size - head > data_size_) {
+      munmap(data_ + data_size_, map_size - head - data_size_);
+    }
+    // Transparent huge pages may be disabled, in which case the arena simply uses small pages.
+    madvise(data_, data_size_, MADV_HUGEPAGE);
+  }
+
+  // The policy has to be set before the pages are first touched, which happens when the frames are zeroed below.
+  if (numa_node >= 0 && numa_node < GetNumNumaNodes() && numa_node < 63) {
+    // The kernel reads maxnode - 1 bits of the mask.
+    uint64_t node_mask = uint64_t{1} << numa_node;
+    if (syscall(SYS_mbind, data_, data_size_, MPOL_PREFERRED_NODE, &node_mask, 64, 0) == 0) {
+      numa_node_ = numa_node;
+    }
+  }
+
+  frames_ = static_cast<Page *>(::operator new[](num_frames_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  for (size_t i = 0; i < num_frames_; i++) {
+    new (&frames_[i]) Page(data_ + i * PAGE_SIZE);
+  }
+}
+
+FrameArena::~FrameArena() {
+  for (size_t i = 0; i < num_frames_; i++) {
+    frames_[i].~Page();
+  }
+  ::operator delete[](frames_, std::align_val_t{alignof(Page)});
+  munmap(data_, data_size_);
+}
+
+int FrameArena::GetNumNumaNodes() {
+  int num_nodes = 0;
+  while (access(("/sys/devices/system/node/node" + std::to_string(num_nodes)).c_str(), F_OK) == 0) {
+    num_nodes++;
+  }
+  return num_nodes > 0 ? num_nodes : 1;
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_reference_period)
+    : k_(k), correlated_reference_period_(correlated_reference_period) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs to look back at least one access.");
+  frames_.reserve(num_pages);
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+void LRUKReplacer::Detach(frame_id_t frame_id, FrameHistory *history) {
+  if (history->accesses_.size() < k_) {
+    history_list_.erase(history->history_pos_);
+  } else {
+    cache_set_.erase({history->accesses_.front(), frame_id});
+  }
+  history->evictable_ = false;
+}
+
+void LRUKReplacer::Attach(frame_id_t frame_id, FrameHistory *history) {
+  if (history->accesses_.size() < k_) {
+    history->history_pos_ = history_list_.insert(history_list_.end(), frame_id);
+  } else {
+    cache_set_.emplace(history->accesses_.front(), frame_id);
+  }
+  history->evictable_ = true;
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  // Frames with an infinite backward k-distance go first, then the frame whose k-th most recent access is oldest.
+  if (!history_list_.empty()) {
+    *frame_id = history_list_.front();
+  } else if (!cache_set_.empty()) {
+    *frame_id = cache_set_.begin()->second;
+  } else {
+    return false;
+  }
+  auto iter = frames_.find(*frame_id);
+  Detach(*frame_id, &iter->second);
+  // The frame will hold another page, so its history is forgotten.
+  frames_.erase(iter);
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end() || !iter->second.evictable_) {
+    return;
+  }
+  Detach(frame_id, &iter->second);
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  FrameHistory &history = frames_[frame_id];
+  if (history.evictable_) {
+    Detach(frame_id, &history);
+  }
+
+  size_t now = ++current_timestamp_;
+  if (!history.accesses_.empty() && now - history.accesses_.back() <= correlated_reference_period_) {
+    // A correlated reference, e.g. the same transaction touching the page again, is not a new access.
+    history.accesses_.back() = now;
+  } else {
+    history.accesses_.push_back(now);
+    if (history.accesses_.size() > k_) {
+      history.accesses_.pop_front();
+    }
+  }
+  Attach(frame_id, &history);
+}
+
+void LRUKReplacer::UnpinPrefetched(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  FrameHistory &history = frames_[frame_id];
+  if (history.evictable_) {
+    return;
+  }
+  // Without any access the frame has an infinite backward k-distance, and it is the most recent of them.
+  Attach(frame_id, &history);
+}
+
+void LRUKReplacer::SetPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  // The frame may not have come from Victim, e.g. a deleted page or a recycled ring frame, so the history of the page
+  // it held is forgotten here too.
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    return;
+  }
+  if (iter->second.evictable_) {
+    Detach(frame_id, &iter->second);
+  }
+  frames_.erase(iter);
+}
+
+std::vector<frame_id_t> LRUKReplacer::PeekVictims(size_t max_frames) {
+  std::scoped_lock lock{latch_};
+  std::vector<frame_id_t> frames;
+  for (auto iter = history_list_.begin(); iter != history_list_.end() && frames.size() < max_frames; ++iter) {
+    frames.push_back(*iter);
+  }
+  for (auto iter = cache_set_.begin(); iter != cache_set_.end() && frames.size() < max_frames; ++iter) {
+    frames.push_back(iter->second);
+  }
+  return frames;
+}
+
+size_t LRUKReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return history_list_.size() + cache_set_.size();
+}
+
+}  // namespace bustub
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.cpp
+//
+// Identification: src/buffer/page_guard.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_guard.h"
+
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_) {
+  that.page_ = nullptr;
+  that.is_dirty_ = false;
+}
+
+BasicPageGuard &BasicPageGuard::operator=(BasicPageGuard &&that) noexcept {
+  if (this != &that) {
+    Drop();
+    bpm_ = that.bpm_;
+    page_ = that.page_;
+    is_dirty_ = that.is_dirty_;
+    that.page_ = nullptr;
+    that.is_dirty_ = false;
+  }
+  return *this;
+}
+
+void BasicPageGuard::Drop() {
+  if (page_ == nullptr) {
+    return;
+  }
+  bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  page_ = nullptr;
+  is_dirty_ = false;
+}
+
+ReadPageGuard BasicPageGuard::UpgradeRead() {
+  ReadPageGuard guard;
+  if (page_ != nullptr) {
+    page_->RLatch();
+    guard.guard_ = std::move(*this);
+  }
+  return guard;
+}
+
+WritePageGuard BasicPageGuard::UpgradeWrite() {
+  WritePageGuard guard;
+  if (page_ != nullptr) {
+    page_->WLatch();
+    guard.guard_ = std::move(*this);
+  }
+  return guard;
+}
+
+ReadPageGuard::ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {
+  if (page != nullptr) {
+    page->RLatch();
+  }
+}
+
+ReadPageGuard &ReadPageGuard::operator=(ReadPageGuard &&that) noexcept {
+  if (this != &that) {
+    Drop();
+    guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+void ReadPageGuard::Drop() {
+  if (guard_.page_ == nullptr) {
+    return;
+  }
+  // Unlatch before unpinning: once the pin is gone the frame may be reused for another page.
+  guard_.page_->RUnlatch();
+  guard_.Drop();
+}
+
+WritePageGuard::WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {
+  if (page != nullptr) {
+    page->WLatch();
+  }
+}
+
+WritePageGuard &WritePageGuard::operator=(WritePageGuard &&that) noexcept {
+  if (this != &that) {
+    Drop();
+    guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+void WritePageGuard::Drop() {
+  if (guard_.page_ == nullptr) {
+    return;
+  }
+  guard_.page_->WUnlatch();
+  guard_.Drop();
+}
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "A parallel buffer pool needs at least one instance.");
+  // Allocate and create the individual BufferPoolManagerInstances.
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; ++i) {
+    instances_.emplace_back(
+        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() { return instances_.size() * pool_size_; }
+
+void ParallelBufferPoolManager::RunPageCleaner(size_t low_watermark_percent, size_t high_watermark_percent) {
+  for (auto *instance : instances_) {
+    instance->RunPageCleaner(low_watermark_percent, high_watermark_percent);
+  }
+}
+
+void ParallelBufferPoolManager::StopPageCleaner() {
+  for (auto *instance : instances_) {
+    instance->StopPageCleaner();
+  }
+}
+
+size_t ParallelBufferPoolManager::GetNumSyncEvictionWrites() {
+  size_t num_writes = 0;
+  for (auto *instance : instances_) {
+    num_writes += instance->GetNumSyncEvictionWrites();
+  }
+  return num_writes;
+}
+
+size_t ParallelBufferPoolManager::GetNumCleanerWrites() {
+  size_t num_writes = 0;
+  for (auto *instance : instances_) {
+    num_writes += instance->GetNumCleanerWrites();
+  }
+  return num_writes;
+}
+
+BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()];
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id, BufferRing *ring) {
+  // The ring is shared by the instances, each of them only recycles the frames of its own pages.
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, ring);
+}
+
+size_t ParallelBufferPoolManager::FetchPagesImpl(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) {
+  std::vector<std::vector<size_t>> positions(instances_.size());
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    positions[static_cast<size_t>(page_ids[i]) % instances_.size()].push_back(i);
+  }
+  pages->assign(page_ids.size(), nullptr);
+  size_t num_fetched = 0;
+  std::vector<page_id_t> instance_page_ids;
+  std::vector<Page *> instance_pages;
+  for (size_t instance = 0; instance < instances_.size(); instance++) {
+    if (positions[instance].empty()) {
+      continue;
+    }
+    instance_page_ids.clear();
+    for (size_t i : positions[instance]) {
+      instance_page_ids.push_back(page_ids[i]);
+    }
+    num_fetched += instances_[instance]->FetchPages(instance_page_ids, &instance_pages);
+    for (size_t j = 0; j < positions[instance].size(); j++) {
+      (*pages)[positions[instance][j]] = instance_pages[j];
+    }
+  }
+  return num_fetched;
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id) {
+  size_t start;
+  {
+    std::scoped_lock lock{latch_};
+    start = next_instance_;
+    next_instance_ = (next_instance_ + 1) % instances_.size();
+  }
+  // Try every instance once, starting from the round robin position, until one of them has a free frame.
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    Page *page = instances_[(start + i) % instances_.size()]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  *page_id = INVALID_PAGE_ID;
+  return nullptr;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  for (auto *instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+bool ParallelBufferPoolManager::PrefetchPageImpl(page_id_t page_id) {
+  // Every instance reads ahead the pages it owns in its own background thread.
+  return GetBufferPoolManager(page_id)->PrefetchPage(page_id);
+}
+
+}  // namespace bustub
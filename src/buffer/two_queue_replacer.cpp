@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages)
+    : TwoQueueReplacer(num_pages, num_pages * TWO_QUEUE_A1IN_PERCENT / 100,
+                       num_pages * TWO_QUEUE_A1OUT_PERCENT / 100) {}
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages, size_t a1in_size, size_t a1out_size)
+    : a1in_size_(a1in_size), a1out_size_(a1out_size) {
+  frames_.reserve(num_pages);
+  a1out_index_.reserve(a1out_size);
+}
+
+TwoQueueReplacer::~TwoQueueReplacer() = default;
+
+TwoQueueReplacer::FrameState *TwoQueueReplacer::Track(frame_id_t frame_id, bool in_am, page_id_t page_id) {
+  FrameState &state = frames_[frame_id];
+  state.in_am_ = in_am;
+  state.evictable_ = false;
+  state.seq_ = ++current_timestamp_;
+  state.page_id_ = page_id;
+  if (!in_am) {
+    a1in_resident_++;
+  }
+  return &state;
+}
+
+void TwoQueueReplacer::Forget(frame_id_t frame_id) {
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end()) {
+    return;
+  }
+  FrameState &state = iter->second;
+  if (state.in_am_) {
+    am_.erase({state.seq_, frame_id});
+  } else {
+    a1in_.erase({state.seq_, frame_id});
+    a1in_resident_--;
+  }
+  frames_.erase(iter);
+}
+
+void TwoQueueReplacer::AddGhost(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID || a1out_size_ == 0) {
+    return;
+  }
+  if (a1out_.size() == a1out_size_) {
+    a1out_index_.erase(a1out_.front());
+    a1out_.pop_front();
+  }
+  a1out_index_[page_id] = a1out_.insert(a1out_.end(), page_id);
+}
+
+bool TwoQueueReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock lock{latch_};
+  // Evict from the probation queue while it is over its share, or when the main queue has nothing evictable.
+  if (!a1in_.empty() && (a1in_resident_ > a1in_size_ || am_.empty())) {
+    *frame_id = a1in_.begin()->second;
+    AddGhost(frames_[*frame_id].page_id_);
+  } else if (!am_.empty()) {
+    *frame_id = am_.begin()->second;
+  } else {
+    return false;
+  }
+  Forget(*frame_id);
+  return true;
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  if (iter == frames_.end() || !iter->second.evictable_) {
+    return;
+  }
+  FrameState &state = iter->second;
+  if (state.in_am_) {
+    am_.erase({state.seq_, frame_id});
+  } else {
+    a1in_.erase({state.seq_, frame_id});
+  }
+  state.evictable_ = false;
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  auto iter = frames_.find(frame_id);
+  FrameState *state = iter == frames_.end() ? Track(frame_id, false, INVALID_PAGE_ID) : &iter->second;
+  if (state->in_am_) {
+    if (state->evictable_) {
+      am_.erase({state->seq_, frame_id});
+    }
+    state->seq_ = ++current_timestamp_;
+    am_.emplace(state->seq_, frame_id);
+  } else {
+    // A1in is a FIFO, an access does not move the frame.
+    a1in_.emplace(state->seq_, frame_id);
+  }
+  state->evictable_ = true;
+}
+
+void TwoQueueReplacer::SetPage(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  Forget(frame_id);
+  auto ghost = a1out_index_.find(page_id);
+  bool in_am = ghost != a1out_index_.end();
+  if (in_am) {
+    a1out_.erase(ghost->second);
+    a1out_index_.erase(ghost);
+  }
+  Track(frame_id, in_am, page_id);
+}
+
+std::vector<frame_id_t> TwoQueueReplacer::PeekVictims(size_t max_frames) {
+  std::scoped_lock lock{latch_};
+  // Replay the choices Victim would make.
+  std::vector<frame_id_t> frames;
+  size_t a1in_resident = a1in_resident_;
+  auto a1in_iter = a1in_.begin();
+  auto am_iter = am_.begin();
+  while (frames.size() < max_frames) {
+    if (a1in_iter != a1in_.end() && (a1in_resident > a1in_size_ || am_iter == am_.end())) {
+      frames.push_back((a1in_iter++)->second);
+      a1in_resident--;
+    } else if (am_iter != am_.end()) {
+      frames.push_back((am_iter++)->second);
+    } else {
+      break;
+    }
+  }
+  return frames;
+}
+
+size_t TwoQueueReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return a1in_.size() + am_.size();
+}
+
+}  // namespace bustub
@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+/** Shortest back reference. */
+constexpr size_t MIN_MATCH = 4;
+/** The last bytes of a block are always literals. */
+constexpr size_t LAST_LITERALS = 5;
+/** No match starts within this many bytes of the end of a block. */
+constexpr size_t MATCH_FIND_LIMIT = 12;
+/** Farthest back reference. */
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+/** A length of 15 in a token continues in the following bytes. */
+constexpr uint32_t RUN_MASK = 15;
+
+uint32_t Read32(const uint8_t *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Write the continuation bytes of a length, returns false if they do not fit. */
+bool WriteLength(size_t length, uint8_t **out, const uint8_t *out_end) {
+  for (; length >= 255; length -= 255) {
+    if (*out == out_end) {
+      return false;
+    }
+    *(*out)++ = 255;
+  }
+  if (*out == out_end) {
+    return false;
+  }
+  *(*out)++ = static_cast<uint8_t>(length);
+  return true;
+}
+
+/** Read the continuation bytes of a length, returns false if the input ends first. */
+bool ReadLength(const uint8_t **in, const uint8_t *in_end, size_t *length) {
+  uint8_t byte;
+  do {
+    if (*in == in_end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/** Write a sequence of literals, followed by a match unless match_length is 0. */
+bool WriteSequence(const uint8_t *literals, size_t num_literals, size_t offset, size_t match_length, uint8_t **out,
+                   const uint8_t *out_end) {
+  if (*out == out_end) {
+    return false;
+  }
+  uint8_t *token = (*out)++;
+  *token = static_cast<uint8_t>(std::min<size_t>(num_literals, RUN_MASK) << 4);
+  if (num_literals >= RUN_MASK && !WriteLength(num_literals - RUN_MASK, out, out_end)) {
+    return false;
+  }
+  if (static_cast<size_t>(out_end - *out) < num_literals) {
+    return false;
+  }
+  memcpy(*out, literals, num_literals);
+  *out += num_literals;
+  if (match_length == 0) {
+    return true;
+  }
+  if (out_end - *out < 2) {
+    return false;
+  }
+  *(*out)++ = static_cast<uint8_t>(offset);
+  *(*out)++ = static_cast<uint8_t>(offset >> 8);
+  match_length -= MIN_MATCH;
+  *token |= static_cast<uint8_t>(std::min<size_t>(match_length, RUN_MASK));
+  return match_length < RUN_MASK || WriteLength(match_length - RUN_MASK, out, out_end);
+}
+
+}  // namespace
+
+size_t CompressionUtil::Compress(const char *src, size_t size, char *dst, size_t capacity) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *out_end = out + capacity;
+  // Position + 1 of the last 4-byte sequence with each hash, 0 for none.
+  std::array<uint32_t, 1 << HASH_BITS> table{};
+
+  size_t anchor = 0;
+  if (size >= MATCH_FIND_LIMIT) {
+    size_t pos = 0;
+    while (pos + MATCH_FIND_LIMIT <= size) {
+      uint32_t sequence = Read32(in + pos);
+      uint32_t &entry = table[Hash(sequence)];
+      size_t candidate = entry;
+      entry = static_cast<uint32_t>(pos + 1);
+      if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || Read32(in + candidate - 1) != sequence) {
+        // Skip ahead faster the longer no match is found, incompressible data is not worth the search.
+        pos += 1 + ((pos - anchor) >> 6);
+        continue;
+      }
+      size_t match = candidate - 1;
+      while (pos > anchor && match > 0 && in[pos - 1] == in[match - 1]) {
+        pos--;
+        match--;
+      }
+      size_t length = MIN_MATCH;
+      while (pos + length < size - LAST_LITERALS && in[pos + length] == in[match + length]) {
+        length++;
+      }
+      if (!WriteSequence(in + anchor, pos - anchor, pos - match, length, &out, out_end)) {
+        return 0;
+      }
+      pos += length;
+      anchor = pos;
+    }
+  }
+  if (!WriteSequence(in + anchor, size - anchor, 0, 0, &out, out_end)) {
+    return 0;
+  }
+  return out - reinterpret_cast<uint8_t *>(dst);
+}
+
+bool CompressionUtil::Decompress(const char *src, size_t size, char *dst, size_t dst_size) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *in_end = in + size;
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  uint8_t *out_end = out + dst_size;
+  while (in < in_end) {
+    uint8_t token = *in++;
+    size_t num_literals = token >> 4;
+    if (num_literals == RUN_MASK && !ReadLength(&in, in_end, &num_literals)) {
+      return false;
+    }
+    if (static_cast<size_t>(in_end - in) < num_literals || static_cast<size_t>(out_end - out) < num_literals) {
+      return false;
+    }
+    memcpy(out, in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    if (in == in_end) {
+      // The last sequence has no match.
+      break;
+    }
+    if (in_end - in < 2) {
+      return false;
+    }
+    size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t length = token & RUN_MASK;
+    if (length == RUN_MASK && !ReadLength(&in, in_end, &length)) {
+      return false;
+    }
+    length += MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(out - reinterpret_cast<uint8_t *>(dst)) ||
+        static_cast<size_t>(out_end - out) < length) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, e.g. a run of one byte, so it is copied byte by byte.
+    const uint8_t *match = out - offset;
+    for (size_t i = 0; i < length; i++) {
+      out[i] = match[i];
+    }
+    out += length;
+  }
+  return out == out_end;
+}
+
+}  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy.
+ *
+ * Resident frames are split between T1, pages accessed once since they were read in, and T2, pages accessed at least
+ * twice. Both are LRU lists. The page ids of frames evicted from T1 and T2 are remembered in the ghost lists B1 and B2,
+ * which together with T1 and T2 cover twice the pool size. A page read in again while it is in B1 means T1 was too
+ * small and raises the target size of T1; one found in B2 lowers it. Victims come from T1 while it is above its target
+ * and from T2 otherwise, so the split between recency and frequency tunes itself to the workload.
+ *
+ * The buffer pool decides when to evict, so the ghost list lookup and adaptation happen when the new page is reported
+ * through SetPage rather than before the victim is picked as in the original algorithm.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_pages);
+
+  /**
+   * Destroys the ARCReplacer.
+   */
+  ~ARCReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void UnpinPrefetched(frame_id_t frame_id) override;
+
+  void SetPage(frame_id_t frame_id, page_id_t page_id) override;
+
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
+  size_t Size() override;
+
+  /** @return the current target size of T1 */
+  size_t GetTargetT1Size();
+
+ private:
+  /** State of a resident frame. */
+  struct FrameState {
+    /** True if the frame is in T2, false if it is in T1. */
+    bool in_t2_{false};
+    /** True if the frame is in t1_ or t2_. */
+    bool evictable_{false};
+    /** True once the access that loaded the page has been recorded. */
+    bool accessed_{false};
+    /** Timestamp of the most recent access. */
+    size_t seq_{0};
+    /** The page the frame holds, INVALID_PAGE_ID if unknown. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** A list of evicted page ids with constant time lookup, least recently evicted first. */
+  struct GhostList {
+    std::list<page_id_t> pages_;
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+
+    size_t Size() const { return pages_.size(); }
+    bool Remove(page_id_t page_id);
+    void Push(page_id_t page_id);
+    void PopOldest();
+  };
+
+  /** Start tracking a frame in T1 or T2. */
+  FrameState *Track(frame_id_t frame_id, bool in_t2, page_id_t page_id);
+
+  /** Detach an evictable frame from t1_ or t2_. */
+  void Detach(frame_id_t frame_id, FrameState *state);
+
+  /** Stop tracking a frame. */
+  void Forget(frame_id_t frame_id);
+
+  /** Drop the oldest ghost entries until the directory fits in twice the pool size. */
+  void TrimGhosts();
+
+  /** The pool size, c in the ARC paper. */
+  const size_t capacity_;
+  /** Target size of T1, p in the ARC paper. */
+  size_t target_t1_{0};
+  /** Logical clock, advanced on every recorded access. */
+  size_t current_timestamp_{0};
+  /** State of every frame that is tracked by the replacer. */
+  std::unordered_map<frame_id_t, FrameState> frames_;
+  /** Number of tracked frames in T1 and T2, evictable or not. */
+  size_t t1_resident_{0};
+  size_t t2_resident_{0};
+  /** Evictable frames in T1 and T2, least recently accessed first. */
+  std::set<std::pair<size_t, frame_id_t>> t1_;
+  std::set<std::pair<size_t, frame_id_t>> t2_;
+  /** Ghost entries of pages evicted from T1 and T2. */
+  GhostList b1_;
+  GhostList b2_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
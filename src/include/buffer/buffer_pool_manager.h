@@ -12,37 +12,35 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <vector>
 
-#include "buffer/lru_replacer.h"
-#include "recovery/log_manager.h"
-#include "storage/disk/disk_manager.h"
+#include "buffer/buffer_ring.h"
+#include "buffer/extent.h"
+#include "buffer/page_guard.h"
+#include "common/config.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * This is the interface shared by a single buffer pool (BufferPoolManagerInstance) and a buffer pool that is
+ * partitioned across several independent instances (ParallelBufferPoolManager). Callers such as TableHeap, BPlusTree
+ * and LinearProbeHashTable only depend on this interface.
  */
 class BufferPoolManager {
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
 
-  /**
-   * Creates a new BufferPoolManager.
-   * @param pool_size the size of the buffer pool
-   * @param disk_manager the disk manager
-   * @param log_manager the log manager (for testing only: nullptr = disable logging)
-   */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager() = default;
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager() = default;
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -52,6 +50,59 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Fetch a page on behalf of a sequential scan, which reads pages it misses into the scan's buffer ring instead of
+   * taking victims from the whole pool. The page is unpinned with UnpinPage as usual.
+   * @param page_id id of page to be fetched
+   * @param ring the buffer ring of the scan, nullptr for an ordinary fetch
+   * @return the requested page, or nullptr if it could not be read in
+   */
+  Page *FetchPage(page_id_t page_id, BufferRing *ring) { return FetchPageImpl(page_id, ring); }
+
+  /**
+   * Fetch a set of pages at once, e.g. the pages of the RIDs an index lookup returned. The misses are read in page id
+   * order with one latch acquisition, and runs of consecutive pages are read with a single disk read. Every fetched
+   * page is pinned once per occurrence in page_ids and unpinned with UnpinPage as usual.
+   * @param page_ids ids of the pages to fetch, in any order and possibly repeated
+   * @param[out] pages the fetched pages, in the order of page_ids; nullptr for the pages that could not be read in
+   *             because every frame is pinned
+   * @return the number of pages that were fetched
+   */
+  size_t FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) {
+    return FetchPagesImpl(page_ids, pages);
+  }
+
+  /**
+   * Fetch a page and wrap its pin in a guard that unpins it when the guard goes out of scope.
+   * @param page_id id of page to be fetched
+   * @param ring the buffer ring of the scan, nullptr for an ordinary fetch
+   * @return a guard for the page, which does not hold a page if it could not be read in
+   */
+  BasicPageGuard FetchPageBasic(page_id_t page_id, BufferRing *ring = nullptr) {
+    return {this, FetchPageImpl(page_id, ring)};
+  }
+
+  /**
+   * Fetch a page and latch it for reading. The guard unlatches and unpins the page when it goes out of scope.
+   * @param page_id id of page to be fetched
+   * @param ring the buffer ring of the scan, nullptr for an ordinary fetch
+   * @return a guard for the page, which does not hold a page if it could not be read in
+   */
+  ReadPageGuard FetchPageRead(page_id_t page_id, BufferRing *ring = nullptr) {
+    return {this, FetchPageImpl(page_id, ring)};
+  }
+
+  /**
+   * Fetch a page and latch it for writing. The guard unlatches and unpins the page when it goes out of scope, as dirty
+   * if WritePageGuard::SetDirty was called.
+   * @param page_id id of page to be fetched
+   * @param ring the buffer ring of the scan, nullptr for an ordinary fetch
+   * @return a guard for the page, which does not hold a page if it could not be read in
+   */
+  WritePageGuard FetchPageWrite(page_id_t page_id, BufferRing *ring = nullptr) {
+    return {this, FetchPageImpl(page_id, ring)};
+  }
+
   /** Grading function. Do not modify! */
   bool UnpinPage(page_id_t page_id, bool is_dirty, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -76,6 +127,31 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Create a new page and wrap its pin in a guard. The new page is unpinned as dirty.
+   * @param[out] page_id id of created page
+   * @return a guard for the new page, which does not hold a page if no new page could be created
+   */
+  BasicPageGuard NewPageGuarded(page_id_t *page_id) {
+    BasicPageGuard guard(this, NewPageImpl(page_id));
+    guard.SetDirty();
+    return guard;
+  }
+
+  /**
+   * Create a new page in the extent of a table heap or index, and wrap its pin in a guard. The page id is the next one
+   * of the extent's run of contiguous page ids, a new run is reserved once the run is used up. The new page is unpinned
+   * as dirty.
+   * @param[out] page_id id of created page
+   * @param extent the extent of the table heap or index
+   * @return a guard for the new page, which does not hold a page if no new page could be created
+   */
+  BasicPageGuard NewPageGuarded(page_id_t *page_id, Extent *extent) {
+    BasicPageGuard guard(this, NewPageInExtent(page_id, extent));
+    guard.SetDirty();
+    return guard;
+  }
+
   /** Grading function. Do not modify! */
   bool DeletePage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -91,11 +167,37 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
-  /** @return pointer to all the pages in the buffer pool */
-  Page *GetPages() { return pages_; }
+  /**
+   * Ask the buffer pool to read a page in the background, ahead of a fetch that is expected soon. This is only a hint:
+   * it is dropped if the page is resident, the read-ahead queue is full or every frame is pinned. The page is not
+   * pinned; a later FetchPage finds it resident, or waits for the read that is in progress.
+   * @param page_id id of the page to read ahead
+   * @return true if a read was queued
+   */
+  bool PrefetchPage(page_id_t page_id) { return PrefetchPageImpl(page_id); }
+
+  /**
+   * Start a background thread that writes back dirty pages before they are evicted. Once fewer than the low watermark
+   * of frames are free or hold clean pages that are next in line for eviction, the cleaner writes back dirty pages
+   * until the high watermark is reached. Pages whose log records are not persistent yet are skipped.
+   * Does nothing if the cleaner is already running.
+   * @param low_watermark_percent low watermark, in percent of the frames
+   * @param high_watermark_percent high watermark, in percent of the frames
+   */
+  virtual void RunPageCleaner(size_t low_watermark_percent = PAGE_CLEANER_LOW_WATERMARK,
+                              size_t high_watermark_percent = PAGE_CLEANER_HIGH_WATERMARK) = 0;
+
+  /** Stop the page cleaner thread, if it is running. */
+  virtual void StopPageCleaner() = 0;
+
+  /** @return the number of dirty pages that were written back while being evicted */
+  virtual size_t GetNumSyncEvictionWrites() = 0;
+
+  /** @return the number of dirty pages that the page cleaner has written back */
+  virtual size_t GetNumCleanerWrites() = 0;
 
   /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  virtual size_t GetPoolSize() = 0;
 
  protected:
   /**
@@ -116,7 +218,23 @@ class BufferPoolManager {
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id) = 0;
+
+  /**
+   * Fetch the requested page from the buffer pool, recycling the frames of a scan's buffer ring on a miss.
+   * @param page_id id of page to be fetched
+   * @param ring the buffer ring of the scan, nullptr for an ordinary fetch
+   * @return the requested page
+   */
+  virtual Page *FetchPageImpl(page_id_t page_id, BufferRing *ring) = 0;
+
+  /**
+   * Fetch a set of pages from the buffer pool.
+   * @param page_ids ids of the pages to fetch
+   * @param[out] pages the fetched pages, in the order of page_ids
+   * @return the number of pages that were fetched
+   */
+  virtual size_t FetchPagesImpl(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,49 +242,79 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty) = 0;
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id) = 0;
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id) = 0;
+
+  /**
+   * Creates a new page in an extent.
+   * @param[out] page_id id of created page
+   * @param extent the extent to take the page id from
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageInExtent(page_id_t *page_id, Extent *extent) {
+    std::scoped_lock lock{extent->latch_};
+    if (extent->next_page_id_ == extent->end_page_id_) {
+      page_id_t first_page_id = AllocateExtentImpl();
+      if (first_page_id == INVALID_PAGE_ID) {
+        *page_id = INVALID_PAGE_ID;
+        return nullptr;
+      }
+      extent->next_page_id_ = first_page_id;
+      extent->end_page_id_ = first_page_id + EXTENT_SIZE;
+    }
+    Page *page = CreatePageImpl(extent->next_page_id_);
+    if (page == nullptr) {
+      *page_id = INVALID_PAGE_ID;
+      return nullptr;
+    }
+    *page_id = extent->next_page_id_++;
+    return page;
+  }
+
+  /**
+   * Reserves a run of EXTENT_SIZE contiguous page ids on disk.
+   * @return the first page id of the run, INVALID_PAGE_ID if the disk is full
+   */
+  virtual page_id_t AllocateExtentImpl() = 0;
+
+  /**
+   * Creates a new page in the buffer pool for a page id that is allocated on disk but has no page yet.
+   * @param page_id id of the page to create
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual Page *CreatePageImpl(page_id_t page_id) = 0;
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id) = 0;
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl();
-
-  /** Number of pages in the buffer pool. */
-  size_t pool_size_;
-  /** Array of buffer pool pages. */
-  Page *pages_;
-  /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  Replacer *replacer_;
-  /** List of free pages. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  virtual void FlushAllPagesImpl() = 0;
+
+  /**
+   * Queues a page to be read into the buffer pool in the background.
+   * @param page_id id of the page to read ahead
+   * @return true if a read was queued
+   */
+  virtual bool PrefetchPageImpl(page_id_t page_id) = 0;
 };
+
 }  // namespace bustub
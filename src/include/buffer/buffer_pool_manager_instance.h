@@ -0,0 +1,360 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.h
+//
+// Identification: src/include/buffer/buffer_pool_manager_instance.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <future>  // NOLINT
+#include <list>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/concurrent_page_table.h"
+#include "buffer/frame_arena.h"
+#include "buffer/replacer.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * BufferPoolManagerInstance is a single buffer pool with its own page table, free list, replacer and latch.
+ *
+ * Fetching or unpinning a resident page does not take the latch: the page is looked up in the lock-free page table
+ * and pinned with a compare-and-swap on its pin count, which is then validated against the frame's page id. Only
+ * misses, new pages, deletions, flushes and evictions take the latch. A frame is claimed for eviction by swapping its
+ * pin count from 0 to FRAME_LOCKED, which makes concurrent optimistic pins fail.
+ *
+ * PrefetchPage hands pages to a background thread that reads them into the pool without holding the latch. The page
+ * is mapped to its frame before the read, with the frame still locked, so a fetch of that page waits for the read to
+ * finish instead of reading the page a second time.
+ *
+ * RunPageCleaner starts a background thread that writes back dirty pages shortly before the replacer would evict
+ * them, so that misses find clean victims and do not have to wait for a write. The cleaner locks a frame while it
+ * writes it, exactly like an eviction does, and leaves pages whose log records are not yet on disk alone.
+ *
+ * If the disk manager has mapped the data files into memory (see DiskManager::MapDataFiles), a miss points the frame
+ * at the page in the mapping instead of reading the page into the frame. The pin accounting stays the same, but such a
+ * page is read-only: whoever write-latches it gets a copy in the frame's own data (see Page::WLatch), which is
+ * unpinned dirty and written back like any other page. The frame gets its own data back when it is reused.
+ */
+class BufferPoolManagerInstance : public BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
+ public:
+  /**
+   * Creates a new BufferPoolManagerInstance.
+   * @param pool_size the size of the buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   */
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
+
+  /**
+   * Creates a new BufferPoolManagerInstance that is one of several instances of a parallel buffer pool.
+   * Page ids allocated by this instance are congruent to instance_index modulo num_instances.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of instances in the parallel buffer pool
+   * @param instance_index index of this instance in the parallel buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
+
+  /**
+   * Destroys an existing BufferPoolManagerInstance.
+   */
+  ~BufferPoolManagerInstance() override;
+
+  /** @return pointer to all the pages in the buffer pool */
+  Page *GetPages() { return pages_; }
+
+  /** @return the arena that holds the frames of the buffer pool */
+  FrameArena *GetArena() { return &arena_; }
+
+  /** @return size of the buffer pool */
+  size_t GetPoolSize() override { return pool_size_; }
+
+  /** @return the number of pages the background prefetcher has read in */
+  size_t GetNumPrefetchedPages() { return num_prefetched_pages_; }
+
+  void RunPageCleaner(size_t low_watermark_percent = PAGE_CLEANER_LOW_WATERMARK,
+                      size_t high_watermark_percent = PAGE_CLEANER_HIGH_WATERMARK) override;
+
+  void StopPageCleaner() override;
+
+  /** @return the number of dirty pages that were written back while being evicted */
+  size_t GetNumSyncEvictionWrites() override { return num_sync_eviction_writes_; }
+
+  /** @return the number of dirty pages that the page cleaner has written back */
+  size_t GetNumCleanerWrites() override { return num_cleaner_writes_; }
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  Page *FetchPageImpl(page_id_t page_id, BufferRing *ring) override;
+
+  size_t FetchPagesImpl(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  page_id_t AllocateExtentImpl() override { return disk_manager_->AllocateExtent(EXTENT_SIZE); }
+
+  Page *CreatePageImpl(page_id_t page_id) override;
+
+  /**
+   * Set up a free frame for a page that has no data on disk yet, and pin it.
+   * @param frame_id the free frame
+   * @param page_id id of the new page
+   * @return the new page
+   */
+  Page *InitNewPage(frame_id_t frame_id, page_id_t page_id);
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+  bool PrefetchPageImpl(page_id_t page_id) override;
+
+  /** Body of the prefetch thread: read ahead queued pages until the instance is destroyed. */
+  void RunPrefetcher();
+
+  /**
+   * Read a page into a free or victim frame without pinning it, unless it is already resident.
+   * @param page_id the page to read
+   */
+  void ReadAhead(page_id_t page_id);
+
+  /**
+   * Drop a queued read ahead of a page that a fetch has read in itself. Otherwise the prefetch thread could read the
+   * page once more after a scan has already used and recycled it.
+   * @param page_id the page that was read
+   */
+  void CancelPrefetch(page_id_t page_id);
+
+  /**
+   * One round of the page cleaner: if fewer than the low watermark of frames are free or clean victims, write back
+   * the dirty frames among the next high watermark of victims.
+   * @return the number of pages written back
+   */
+  size_t CleanPages();
+
+  /**
+   * Start writing back an unpinned dirty frame without evicting it, unless the log records of its page are not
+   * persistent. The frame stays locked until FinishWriteBack is called.
+   * @param frame_id the frame to write back
+   * @param[out] write the write that was started
+   * @return true if a write was started, false if the frame was left alone
+   */
+  bool StartWriteBack(frame_id_t frame_id, std::future<bool> *write);
+
+  /**
+   * Unlock a frame once its write back has completed.
+   * @param frame_id the frame that was written back
+   * @param written true if the write succeeded, which makes the frame clean
+   */
+  void FinishWriteBack(frame_id_t frame_id, bool written);
+
+  /**
+   * Look up a page under the latch, waiting for a read ahead of the page to finish if one is in progress.
+   * @param lock the held latch_, released while waiting
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame that holds the page
+   * @return true if the page is resident
+   */
+  bool FindReadFrame(std::unique_lock<std::mutex> *lock, page_id_t page_id, frame_id_t *frame_id);
+
+  /**
+   * Find a frame to hold a new page, taking it from the free list first and from the replacer otherwise.
+   * A dirty victim is written back and removed from the page table. Must be called with latch_ held.
+   * The returned frame is locked (its pin count is FRAME_LOCKED) until the caller publishes a new pin count.
+   * @param lock the held latch_, released while waiting for the page cleaner or while writing back a dirty victim
+   * @param[out] frame_id id of the frame that can be reused
+   * @param[out] waited set to true if the latch was released, in which case the caller has to look up the page it
+   * wants to read in again, since someone else may have read it in meanwhile
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindFreeFrame(std::unique_lock<std::mutex> *lock, frame_id_t *frame_id, bool *waited = nullptr);
+
+  /** Put a frame returned by FindFreeFrame back on the free list unused. Must be called with latch_ held. */
+  void ReturnFreeFrame(frame_id_t frame_id);
+
+  /**
+   * Find a frame for a page that a scan reads through its buffer ring: the frame of the oldest page this instance read
+   * in for the ring, if the ring is full and nobody has pinned that page since. Must be called with latch_ held.
+   * The returned frame is locked, like one returned by FindFreeFrame.
+   * @param lock the held latch_, released while writing back a dirty page
+   * @param ring the buffer ring of the scan
+   * @param[out] frame_id id of the frame that can be reused
+   * @param[out] waited set to true if the latch was released, like for FindFreeFrame
+   * @return false if the caller should fall back to FindFreeFrame
+   */
+  bool FindRingFrame(std::unique_lock<std::mutex> *lock, BufferRing *ring, frame_id_t *frame_id, bool *waited);
+
+  /**
+   * Write back a frame that was claimed for eviction if it is dirty, and remove its page from the page table.
+   * Must be called with latch_ held. The latch is released during the write: the frame stays locked and its page stays
+   * in the page table meanwhile, so fetchers of the page wait for the write rather than read a stale copy.
+   * @param lock the held latch_
+   * @param page the locked frame
+   * @param[out] waited set to true if the latch was released, may be nullptr
+   */
+  void EvictPage(std::unique_lock<std::mutex> *lock, Page *page, bool *waited);
+
+  /**
+   * Point a locked frame at its page in the memory mapping of the data files, instead of reading the page into it.
+   * @param page the locked frame, whose page id is set
+   * @return false if the page is not mapped and has to be read
+   */
+  bool MapFrame(Page *page) {
+    const char *data = disk_manager_->ReadMappedPage(page->page_id_);
+    if (data == nullptr) {
+      return false;
+    }
+    page->data_ = const_cast<char *>(data);
+    return true;
+  }
+
+  /**
+   * Give a locked frame its own data back, if it points at a page in the memory mapping.
+   * @param page the locked frame
+   */
+  void UnmapFrame(Page *page) { page->data_ = page->frame_data_; }
+
+  /**
+   * Pin the frame if it still holds the given page, without taking the latch.
+   * @param frame_id the frame that the page table mapped the page to
+   * @param page_id the page that is expected to be in the frame
+   * @return the pinned page, or nullptr if the frame is locked or holds another page
+   */
+  Page *TryPinFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Drop one pin from a frame, handing the frame to the replacer when the pin count reaches 0.
+   * @param frame_id the frame to unpin
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /**
+   * Hand a frame whose pin count dropped to 0 to the replacer as a fresh access. Frames pinned without the latch are
+   * not removed from the replacer, so the frame is taken out first to refresh its position.
+   * @param frame_id the frame that became unpinned
+   */
+  void MakeEvictable(frame_id_t frame_id) {
+    replacer_->Pin(frame_id);
+    replacer_->Unpin(frame_id);
+  }
+
+  /**
+   * Allocate a page id on disk for this instance, congruent to instance_index_ modulo num_instances_.
+   * @return the id of the allocated page, INVALID_PAGE_ID if the data files are full
+   */
+  page_id_t AllocatePage();
+
+  /**
+   * Deallocate a page on disk.
+   * @param page_id id of the page to deallocate
+   */
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+  /** Assert that a page id belongs to this instance. */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /**
+   * Spread the instances of a parallel buffer pool round-robin over the NUMA nodes of the machine.
+   * @return the NUMA node to place the frames of an instance on, -1 to leave placement to the kernel
+   */
+  static int ChooseNumaNode(uint32_t num_instances, uint32_t instance_index) {
+    int num_nodes = FrameArena::GetNumNumaNodes();
+    return num_instances > 1 && num_nodes > 1 ? static_cast<int>(instance_index % num_nodes) : -1;
+  }
+
+  /** Pin count of a frame that is free or owned by the thread holding latch_. */
+  static constexpr int FRAME_LOCKED = -1;
+
+  /** Number of pages in the buffer pool. */
+  const size_t pool_size_;
+  /** How many instances are in the parallel buffer pool (1 if this instance is used on its own). */
+  const uint32_t num_instances_ = 1;
+  /** Index of this instance in the parallel buffer pool. */
+  const uint32_t instance_index_ = 0;
+  /** Frames of the buffer pool. */
+  FrameArena arena_;
+  /** Array of buffer pool pages, i.e. the frames of arena_. */
+  Page *pages_;
+  /** True if the page data of arena_ is registered with the disk manager. */
+  bool registered_buffer_{false};
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Pointer to the log manager. */
+  LogManager *log_manager_;
+  /** Page table for keeping track of buffer pool pages, readable without latch_ and written only with it. */
+  ConcurrentPageTable page_table_;
+  /**
+   * Replacer to find unpinned pages for replacement. Frames pinned without the latch are not removed from it, so a
+   * victim is only used if its pin count can still be swapped from 0 to FRAME_LOCKED.
+   */
+  Replacer *replacer_;
+  /** List of free pages. */
+  std::list<frame_id_t> free_list_;
+  /** Serializes page table writers, free_list_ and frame (re)assignment, i.e. everything except resident hits. */
+  std::mutex latch_;
+  /** Signalled with latch_ when a read ahead or a write back by the page cleaner unlocks a frame. */
+  std::condition_variable frame_unlocked_;
+
+  /** Pages waiting to be read ahead, oldest first. */
+  std::deque<page_id_t> prefetch_queue_;
+  /** Set when the instance is destroyed to stop the prefetch thread. */
+  bool prefetch_shutdown_{false};
+  /** Protects prefetch_queue_ and prefetch_shutdown_. */
+  std::mutex prefetch_latch_;
+  /** Signalled when a page is queued or the prefetch thread has to stop. */
+  std::condition_variable prefetch_cv_;
+  /** Starts the prefetch thread on the first PrefetchPage. */
+  std::once_flag prefetch_started_;
+  /** Background thread that reads ahead pages. */
+  std::thread prefetch_thread_;
+  /** Number of pages the prefetch thread has read in. */
+  std::atomic<size_t> num_prefetched_pages_{0};
+
+  /** Number of free or clean victim frames below which the page cleaner starts writing back. */
+  size_t cleaner_low_watermark_{0};
+  /** Number of free or clean victim frames the page cleaner tries to reach. */
+  size_t cleaner_high_watermark_{0};
+  /** Set to stop the page cleaner. */
+  bool cleaner_shutdown_{false};
+  /** Protects cleaner_thread_ and cleaner_shutdown_. */
+  std::mutex cleaner_latch_;
+  /** Signalled when an eviction had to write a dirty page or the page cleaner has to stop. */
+  std::condition_variable cleaner_cv_;
+  /** Background thread that writes back dirty pages. */
+  std::thread cleaner_thread_;
+  /** Number of dirty pages written back while being evicted. */
+  std::atomic<size_t> num_sync_eviction_writes_{0};
+  /** Number of dirty pages written back by the page cleaner. */
+  std::atomic<size_t> num_cleaner_writes_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.h
+//
+// Identification: src/include/buffer/buffer_ring.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BufferRing is an access hint for BufferPoolManager::FetchPage that marks the caller as a large sequential scan.
+ *
+ * A scan reads every page of a table once, so letting it take victims from the whole pool would evict the working set
+ * of everyone else. Once a scan has moved through a quarter of the pool's worth of pages, pages it has to read from
+ * disk are instead loaded into a small ring of frames that the scan recycles: the frame of the oldest page the ring
+ * loaded is reused for the next miss. Pages that are already resident are used in place and are not added to the
+ * ring, and a ring page that is pinned by someone else when its turn comes is left in the pool and replaced by an
+ * ordinary victim. Small scans never reach the threshold and behave exactly like ordinary fetches, so small tables
+ * stay cached. A table iterator fetches its page once per tuple, so the threshold counts page changes, not fetches.
+ *
+ * A BufferRing belongs to a single scan and is not thread-safe.
+ */
+class BufferRing {
+  friend class BufferPoolManagerInstance;
+
+ public:
+  /**
+   * Create a ring sized for a buffer pool.
+   * @param pool_size the total number of frames of the buffer pool the scan reads through
+   */
+  explicit BufferRing(size_t pool_size)
+      : capacity_(std::clamp<size_t>(pool_size / 8, 2, SCAN_RING_SIZE)), start_after_(pool_size / 4) {}
+
+  /** @return the maximum number of pages the ring recycles */
+  size_t GetCapacity() const { return capacity_; }
+
+  /** @return the number of pages the scan has moved through so far */
+  size_t GetNumPages() const { return num_pages_; }
+
+ private:
+  /**
+   * Count a fetch, as a new page only if it differs from the page of the previous fetch.
+   * @return true if the scan is large enough for its misses to go through the ring
+   */
+  bool RecordFetch(page_id_t page_id) {
+    if (page_id != last_page_id_) {
+      last_page_id_ = page_id;
+      num_pages_++;
+    }
+    return num_pages_ > start_after_;
+  }
+
+  /** Record a page that was read into the pool for the ring, dropping the oldest page if the ring is over capacity. */
+  void AddPage(page_id_t page_id) {
+    pages_.push_back(page_id);
+    if (pages_.size() > capacity_) {
+      pages_.pop_front();
+    }
+  }
+
+  /** Maximum number of pages in the ring. */
+  const size_t capacity_;
+  /** Number of pages after which misses go through the ring. */
+  const size_t start_after_;
+  /** Number of page changes so far. */
+  size_t num_pages_{0};
+  /** The page of the previous fetch. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** Pages read in for the ring, oldest first. */
+  std::deque<page_id_t> pages_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.h
+//
+// Identification: src/include/buffer/concurrent_page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ConcurrentPageTable maps resident page ids to frame ids for a buffer pool instance.
+ *
+ * The table is open-addressed with linear probing and each slot is a single 64-bit atomic word holding both the page
+ * id and the frame id, so readers never observe a torn entry. Lookups do not take any lock. Insert and Remove must be
+ * serialized by the caller (the buffer pool latch), which keeps the table free of tombstones: removal shifts later
+ * entries of the probe sequence backwards instead.
+ *
+ * Lookups racing with a writer can therefore return a stale frame or miss an entry that is being moved. The buffer
+ * pool tolerates both: a hit is validated by pinning the frame and re-checking its page id, and a miss falls back to
+ * a lookup under the latch.
+ */
+class ConcurrentPageTable {
+ public:
+  /**
+   * Create a new ConcurrentPageTable.
+   * @param num_frames the maximum number of entries the table will hold, i.e. the buffer pool size
+   */
+  explicit ConcurrentPageTable(size_t num_frames);
+
+  /**
+   * Look up a page without taking any lock.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame that held the page when its slot was read
+   * @return true if an entry for the page was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Insert or overwrite the entry for a page. Callers must serialize Insert and Remove.
+   * @param page_id the page to insert
+   * @param frame_id the frame that holds the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Remove the entry for a page. Callers must serialize Insert and Remove.
+   * @param page_id the page to remove
+   * @return true if the page had an entry
+   */
+  bool Remove(page_id_t page_id);
+
+  /** @return the number of entries in the table, only exact when no writer is active */
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  /**
+   * Call a function on every entry. Must be called with writers excluded.
+   * @param func the function to call with (page_id, frame_id)
+   */
+  template <typename Func>
+  void ForEach(Func &&func) const {
+    for (size_t i = 0; i < capacity_; ++i) {
+      uint64_t slot = slots_[i].load(std::memory_order_acquire);
+      if (slot != EMPTY_SLOT) {
+        func(SlotPageId(slot), SlotFrameId(slot));
+      }
+    }
+  }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static uint64_t MakeSlot(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t SlotPageId(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t SlotFrameId(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the home slot of a page id (Fibonacci hashing, so sequential page ids spread over the table) */
+  size_t HomeSlot(page_id_t page_id) const {
+    return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                               (64 - log_capacity_));
+  }
+
+  /** Number of slots, a power of two that is at least twice the number of frames. */
+  size_t capacity_;
+  /** log2(capacity_). */
+  uint32_t log_capacity_;
+  /** The slots, EMPTY_SLOT if unused. */
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  /** Number of entries. */
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace bustub
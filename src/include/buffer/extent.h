@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent.h
+//
+// Identification: src/include/buffer/extent.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Extent is the allocation state of one table heap or index for BufferPoolManager::NewPageGuarded.
+ *
+ * Pages created through an extent are taken from a run of EXTENT_SIZE contiguous page ids that is reserved for the
+ * structure as a whole, and a new run is only reserved once the current one is used up. The pages of the structure
+ * are therefore contiguous in the database file instead of interleaving with the pages of every other table and index
+ * that grows at the same time, so a sequential scan or a walk of a leaf chain reads the file in long sequential runs.
+ *
+ * An extent is only kept in memory. The pages of a reserved run that were never created stay allocated when the
+ * structure is closed.
+ */
+class Extent {
+  friend class BufferPoolManager;
+
+ public:
+  Extent() = default;
+
+  DISALLOW_COPY_AND_MOVE(Extent);
+
+  /** @return the first page id of the run pages are taken from, INVALID_PAGE_ID if no run was reserved yet */
+  page_id_t GetFirstPageId() {
+    std::scoped_lock lock{latch_};
+    return next_page_id_ == INVALID_PAGE_ID ? INVALID_PAGE_ID : end_page_id_ - EXTENT_SIZE;
+  }
+
+  /** @return the number of page ids left in the run */
+  int GetNumFreePages() {
+    std::scoped_lock lock{latch_};
+    return end_page_id_ - next_page_id_;
+  }
+
+ private:
+  /** Protects everything below, and is held while a page is created so that its page id is only taken on success. */
+  std::mutex latch_;
+  /** Next page id of the run to create a page for. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** First page id past the run. */
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the frames of a buffer pool.
+ *
+ * The page data of all frames is one anonymous memory mapping. Once it spans at least a huge page, the mapping is
+ * aligned to HUGE_PAGE_SIZE and the kernel is asked to back it with transparent huge pages, so that a large pool needs
+ * few TLB entries. The book-keeping of the frames (the Page objects) is a separate array in which every Page takes up
+ * whole cache lines, so that pinning one frame does not bounce the cache line of its neighbours, and scanning the
+ * book-keeping does not walk through the page data.
+ *
+ * An arena can be placed on a NUMA node, so that the instances of a parallel buffer pool can be spread over the nodes.
+ * Placement is a preference: if the node runs out of memory, or NUMA placement is not supported, memory comes from
+ * wherever the kernel puts it.
+ */
+class FrameArena {
+ public:
+  /**
+   * Allocate the frames of a buffer pool. The page data of every frame is zeroed.
+   * @param num_frames the number of frames
+   * @param numa_node the NUMA node to place the page data on, -1 to leave placement to the kernel
+   */
+  explicit FrameArena(size_t num_frames, int numa_node = -1);
+
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the array of frames */
+  Page *GetFrames() { return frames_; }
+
+  /** @return the start of the page data of all frames */
+  char *GetData() { return data_; }
+
+  /** @return the size of the page data mapping, in byte */
+  size_t GetDataSize() const { return data_size_; }
+
+  /** @return true if the kernel was asked to back the page data with huge pages */
+  bool UsesHugePages() const { return huge_pages_; }
+
+  /** @return the NUMA node the page data was placed on, -1 if it was not placed */
+  int GetNumaNode() const { return numa_node_; }
+
+  /** @return the number of NUMA nodes of the machine, 1 if that cannot be determined */
+  static int GetNumNumaNodes();
+
+ private:
+  /** Number of frames. */
+  const size_t num_frames_;
+  /** Size of the page data mapping, in byte. */
+  size_t data_size_;
+  /** Page data of all frames. */
+  char *data_;
+  /** Book-keeping of all frames. */
+  Page *frames_;
+  /** True if the page data was advised to use huge pages. */
+  bool huge_pages_{false};
+  /** NUMA node of the page data, -1 if it was not placed. */
+  int numa_node_{-1};
+};
+
+}  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The backward k-distance of a frame is the difference between the current timestamp and the timestamp of its k-th
+ * most recent access. The victim is the evictable frame with the largest backward k-distance. Frames with fewer than
+ * k recorded accesses have an infinite backward k-distance and are evicted first, least recently accessed first, so a
+ * page touched once by a sequential scan is evicted before a page that is looked up repeatedly.
+ *
+ * An access is recorded every time a frame is unpinned, i.e. once per pin episode. Accesses that follow the previous
+ * access of the same frame within the correlated reference period are treated as the same reference and only move its
+ * most recent timestamp forward. A table scan pins a page once per tuple, so without the period every scanned page
+ * would reach k accesses as soon as it is read.
+ *
+ * The history belongs to the page in the frame, it is forgotten when the frame is victimized or given a new page.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses that make up a frame's history
+   * @param correlated_reference_period accesses at most this many timestamps apart count as one reference
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K,
+                        size_t correlated_reference_period = LRUK_CORRELATED_PERIOD);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void UnpinPrefetched(frame_id_t frame_id) override;
+
+  void SetPage(frame_id_t frame_id, page_id_t page_id) override;
+
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
+  size_t Size() override;
+
+ private:
+  /** Access history of a frame. */
+  struct FrameHistory {
+    /** Timestamps of the (at most k) most recent accesses, oldest first. */
+    std::deque<size_t> accesses_;
+    /** True if the frame is in history_list_ or cache_set_. */
+    bool evictable_{false};
+    /** Position in history_list_ if the frame is evictable and has fewer than k accesses. */
+    std::list<frame_id_t>::iterator history_pos_;
+  };
+
+  /** Remove an evictable frame from history_list_ or cache_set_. */
+  void Detach(frame_id_t frame_id, FrameHistory *history);
+
+  /** Add a frame to history_list_ or cache_set_ depending on its number of accesses. */
+  void Attach(frame_id_t frame_id, FrameHistory *history);
+
+  const size_t k_;
+  const size_t correlated_reference_period_;
+  /** Logical clock, advanced on every recorded access. */
+  size_t current_timestamp_{0};
+  /** Access history of every frame that is tracked by the replacer. */
+  std::unordered_map<frame_id_t, FrameHistory> frames_;
+  /** Evictable frames with fewer than k accesses, from least (front) to most (back) recently accessed. */
+  std::list<frame_id_t> history_list_;
+  /** Evictable frames with k accesses, ordered by their k-th most recent access (largest k-distance first). */
+  std::set<std::pair<size_t, frame_id_t>> cache_set_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
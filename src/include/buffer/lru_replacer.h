@@ -14,6 +14,7 @@
 
 #include <list>
 #include <mutex>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -43,10 +44,17 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** Unpinned frames, from least recently unpinned (front) to most recently unpinned (back). */
+  std::list<frame_id_t> lru_list_;
+  /** Position of every unpinned frame in lru_list_. */
+  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> lru_map_;
+  /** Protects lru_list_ and lru_map_. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/buffer/page_guard.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class ReadPageGuard;
+class WritePageGuard;
+
+/**
+ * BasicPageGuard owns one pin of a page and unpins it when it is dropped or destroyed, so that a page cannot be left
+ * pinned on an early return. The guard does not latch the page; ReadPageGuard and WritePageGuard also hold the page's
+ * read or write latch.
+ *
+ * Guards are movable but not copyable. A guard that was moved from, dropped, or created for a fetch that failed does
+ * not hold a page. The page is unpinned as dirty if SetDirty was called while the guard held it.
+ */
+class BasicPageGuard {
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+ public:
+  BasicPageGuard() = default;
+
+  /**
+   * Take over a pin of a page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page, nullptr for a guard that does not hold a page
+   */
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+  DISALLOW_COPY(BasicPageGuard);
+
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+
+  /** Drop the page held by this guard, then take over the page of that guard. */
+  BasicPageGuard &operator=(BasicPageGuard &&that) noexcept;
+
+  ~BasicPageGuard() { Drop(); }
+
+  /** Unpin the page. The guard no longer holds a page afterwards. Does nothing if the guard does not hold a page. */
+  void Drop();
+
+  /**
+   * Latch the page for reading, and hand its pin over to a read guard. This guard no longer holds the page afterwards.
+   * @return the read guard
+   */
+  ReadPageGuard UpgradeRead();
+
+  /**
+   * Latch the page for writing, and hand its pin over to a write guard. This guard no longer holds the page afterwards.
+   * @return the write guard
+   */
+  WritePageGuard UpgradeWrite();
+
+  /** @return true if the guard holds a page */
+  bool IsValid() const { return page_ != nullptr; }
+
+  /** @return the page held by the guard, nullptr if it does not hold one */
+  Page *GetPage() const { return page_; }
+
+  /** @return the id of the page held by the guard */
+  page_id_t PageId() const { return page_->GetPageId(); }
+
+  /** @return the data of the page held by the guard */
+  char *GetData() const { return page_->GetData(); }
+
+  /** Mark the page as modified, so that it is unpinned as dirty. */
+  void SetDirty() { is_dirty_ = true; }
+
+ private:
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+};
+
+/**
+ * ReadPageGuard owns one pin and the read latch of a page, and releases both when it is dropped or destroyed.
+ */
+class ReadPageGuard {
+  friend class BasicPageGuard;
+
+ public:
+  ReadPageGuard() = default;
+
+  /**
+   * Take over a pin of a page and latch the page for reading.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page, nullptr for a guard that does not hold a page
+   */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page);
+
+  DISALLOW_COPY(ReadPageGuard);
+
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
+  /** Drop the page held by this guard, then take over the page of that guard. */
+  ReadPageGuard &operator=(ReadPageGuard &&that) noexcept;
+
+  ~ReadPageGuard() { Drop(); }
+
+  /** Unlatch and unpin the page. Does nothing if the guard does not hold a page. */
+  void Drop();
+
+  /** @return true if the guard holds a page */
+  bool IsValid() const { return guard_.IsValid(); }
+
+  /** @return the page held by the guard, nullptr if it does not hold one */
+  Page *GetPage() const { return guard_.GetPage(); }
+
+  /** @return the id of the page held by the guard */
+  page_id_t PageId() const { return guard_.PageId(); }
+
+  /** @return the data of the page held by the guard */
+  const char *GetData() const { return guard_.GetData(); }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard owns one pin and the write latch of a page, and releases both when it is dropped or destroyed.
+ */
+class WritePageGuard {
+  friend class BasicPageGuard;
+
+ public:
+  WritePageGuard() = default;
+
+  /**
+   * Take over a pin of a page and latch the page for writing.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page, nullptr for a guard that does not hold a page
+   */
+  WritePageGuard(BufferPoolManager *bpm, Page *page);
+
+  DISALLOW_COPY(WritePageGuard);
+
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+
+  /** Drop the page held by this guard, then take over the page of that guard. */
+  WritePageGuard &operator=(WritePageGuard &&that) noexcept;
+
+  ~WritePageGuard() { Drop(); }
+
+  /** Unlatch and unpin the page. Does nothing if the guard does not hold a page. */
+  void Drop();
+
+  /** @return true if the guard holds a page */
+  bool IsValid() const { return guard_.IsValid(); }
+
+  /** @return the page held by the guard, nullptr if it does not hold one */
+  Page *GetPage() const { return guard_.GetPage(); }
+
+  /** @return the id of the page held by the guard */
+  page_id_t PageId() const { return guard_.PageId(); }
+
+  /** @return the data of the page held by the guard */
+  char *GetData() const { return guard_.GetData(); }
+
+  /** Mark the page as modified, so that it is unpinned as dirty. */
+  void SetDirty() { guard_.SetDirty(); }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+}  // namespace bustub
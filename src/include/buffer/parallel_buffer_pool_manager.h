@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager partitions the buffer pool across several independent BufferPoolManagerInstances.
+ * A page is owned by the instance at index (page_id % num_instances), so operations on pages owned by different
+ * instances never contend on the same latch.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the sum of the pool sizes of all the instances */
+  size_t GetPoolSize() override;
+
+  /** Start the page cleaner of every instance, the watermarks apply to each instance separately. */
+  void RunPageCleaner(size_t low_watermark_percent = PAGE_CLEANER_LOW_WATERMARK,
+                      size_t high_watermark_percent = PAGE_CLEANER_HIGH_WATERMARK) override;
+
+  void StopPageCleaner() override;
+
+  /** @return the number of dirty pages written back while being evicted, summed over the instances */
+  size_t GetNumSyncEvictionWrites() override;
+
+  /** @return the number of dirty pages written back by the page cleaners, summed over the instances */
+  size_t GetNumCleanerWrites() override;
+
+  /** @return the number of instances the buffer pool is partitioned across */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManager that is responsible for handling the given page id
+   */
+  BufferPoolManager *GetBufferPoolManager(page_id_t page_id);
+
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  Page *FetchPageImpl(page_id_t page_id, BufferRing *ring) override;
+
+  /** Split the batch by instance, each instance fetches its share with one latch acquisition. */
+  size_t FetchPagesImpl(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Creates a new page. Instances are tried in round robin order, starting one past the instance that was tried
+   * first by the previous call, until one of them has a frame available.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  /** The instances share the disk manager, so any of them can reserve the run. */
+  page_id_t AllocateExtentImpl() override { return instances_[0]->AllocateExtentImpl(); }
+
+  /** Create the page in the instance that owns it. */
+  Page *CreatePageImpl(page_id_t page_id) override {
+    return instances_[static_cast<size_t>(page_id) % instances_.size()]->CreatePageImpl(page_id);
+  }
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+  bool PrefetchPageImpl(page_id_t page_id) override;
+
+  /** The instances, indexed by page_id % instances_.size(). */
+  std::vector<BufferPoolManagerInstance *> instances_;
+  /** Size of each instance. */
+  size_t pool_size_;
+  /** Instance that the next NewPage call starts at. */
+  size_t next_instance_ = 0;
+  /** Protects next_instance_. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
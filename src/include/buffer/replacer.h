@@ -12,10 +12,24 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be created with. */
+enum class ReplacerType {
+  /** Least recently used (LRUReplacer). */
+  LRU,
+  /** Largest backward k-distance (LRUKReplacer). */
+  LRU_K,
+  /** FIFO probation queue in front of an LRU main queue (TwoQueueReplacer). */
+  TWO_QUEUE,
+  /** Adaptive replacement cache (ARCReplacer). */
+  ARC,
+};
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,6 +57,31 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Unpins a frame whose page was read in ahead of its first access, e.g. by a prefetch. Unlike Unpin, no access is
+   * recorded, so that the fetch that follows counts as the first access rather than a re-reference. The default treats
+   * it like Unpin.
+   * @param frame_id the id of the frame to unpin
+   */
+  virtual void UnpinPrefetched(frame_id_t frame_id) { Unpin(frame_id); }
+
+  /**
+   * Tells the replacer that a frame now holds a page that was just read in or created. It is called while the frame is
+   * pinned, before the Unpin that records the access which loaded the page. Policies that remember evicted pages use
+   * the page id to recognize re-references; the default ignores it.
+   * @param frame_id the id of the frame
+   * @param page_id the id of the page the frame now holds
+   */
+  virtual void SetPage(frame_id_t frame_id, page_id_t page_id) {}
+
+  /**
+   * Lists the frames that would be victimized next, without removing them. Background work that prepares frames for
+   * eviction uses this; policies that cannot tell cheaply return nothing.
+   * @param max_frames the maximum number of frames to list
+   * @return up to max_frames frame ids, the next victim first
+   */
+  virtual std::vector<frame_id_t> PeekVictims(size_t max_frames) { return {}; }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q replacement policy.
+ *
+ * A page read in for the first time enters A1in, a FIFO probation queue. Re-accesses while in A1in do not change its
+ * position, so a burst of accesses by a single scan does not make a page look hot. When A1in holds more than its share
+ * of the pool its oldest frame is evicted and the page id is remembered in A1out, a bounded FIFO of ghost entries. A
+ * page that is read in again while still remembered in A1out has proven to be re-referenced over a longer period and
+ * enters Am, an LRU queue that holds the working set. Am is only evicted from when A1in is within its share.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer with the default queue sizes.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_pages);
+
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   * @param a1in_size the number of resident frames A1in may hold before it is evicted from first
+   * @param a1out_size the number of evicted page ids remembered in A1out
+   */
+  TwoQueueReplacer(size_t num_pages, size_t a1in_size, size_t a1out_size);
+
+  /**
+   * Destroys the TwoQueueReplacer.
+   */
+  ~TwoQueueReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void SetPage(frame_id_t frame_id, page_id_t page_id) override;
+
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
+  size_t Size() override;
+
+ private:
+  /** State of a resident frame. */
+  struct FrameState {
+    /** True if the frame is in Am, false if it is in A1in. */
+    bool in_am_{false};
+    /** True if the frame is in a1in_ or am_. */
+    bool evictable_{false};
+    /** Position in its queue: the load time in A1in, the most recent access in Am. */
+    size_t seq_{0};
+    /** The page the frame holds, INVALID_PAGE_ID if unknown. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** Start tracking a frame in A1in or Am. */
+  FrameState *Track(frame_id_t frame_id, bool in_am, page_id_t page_id);
+
+  /** Stop tracking a frame. */
+  void Forget(frame_id_t frame_id);
+
+  /** Remember an evicted page in A1out, dropping the oldest ghost if A1out is full. */
+  void AddGhost(page_id_t page_id);
+
+  const size_t a1in_size_;
+  const size_t a1out_size_;
+  /** Logical clock, advanced on every recorded access. */
+  size_t current_timestamp_{0};
+  /** State of every frame that is tracked by the replacer. */
+  std::unordered_map<frame_id_t, FrameState> frames_;
+  /** Number of tracked frames in A1in, evictable or not. */
+  size_t a1in_resident_{0};
+  /** Evictable frames in A1in, ordered by load time. */
+  std::set<std::pair<size_t, frame_id_t>> a1in_;
+  /** Evictable frames in Am, ordered by most recent access. */
+  std::set<std::pair<size_t, frame_id_t>> am_;
+  /** Ghost entries of pages evicted from A1in, oldest first. */
+  std::list<page_id_t> a1out_;
+  /** Position of every ghost entry in a1out_. */
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_index_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,7 +12,7 @@
 
 #include <string>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/checkpoint_manager.h"
@@ -23,16 +23,25 @@ namespace bustub {
 
 class BustubInstance {
  public:
-  explicit BustubInstance(const std::string &db_file_name) {
+  /**
+   * Open a database.
+   * @param db_file_name the database file
+   * @param read_only true to serve pages from a read-only memory mapping of the database file, e.g. for a read-mostly
+   * replica; a page is copied out of the mapping when it is latched for writing
+   */
+  explicit BustubInstance(const std::string &db_file_name, bool read_only = false) {
     enable_logging = false;
 
     // storage related
     disk_manager_ = new DiskManager(db_file_name);
+    if (read_only) {
+      disk_manager_->MapDataFiles();
+    }
 
     // log related
     log_manager_ = new LogManager(disk_manager_);
 
-    buffer_pool_manager_ = new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManagerInstance(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
 
     // txn related
     lock_manager_ = new LockManager();
@@ -55,7 +64,7 @@ class BustubInstance {
   }
 
   DiskManager *disk_manager_;
-  BufferPoolManager *buffer_pool_manager_;
+  BufferPoolManagerInstance *buffer_pool_manager_;
   LockManager *lock_manager_;
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
@@ -16,6 +16,11 @@
 #include <chrono>  // NOLINT
 #include <cstdint>
 
+/** The page size is chosen at build time, see BUSTUB_PAGE_SIZE in CMakeLists.txt. */
+#ifndef BUSTUB_PAGE_SIZE
+#define BUSTUB_PAGE_SIZE 4096
+#endif
+
 namespace bustub {
 
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
@@ -31,10 +36,30 @@ static constexpr int INVALID_PAGE_ID = -1;                                    //
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int PAGE_SIZE = BUSTUB_PAGE_SIZE;                            // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
+static constexpr int CACHE_LINE_SIZE = 64;                                    // size of a cpu cache line in byte
+static constexpr int HUGE_PAGE_SIZE = 2 * 1024 * 1024;                        // size of a huge page in byte
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;                                     // lookback window for lru-k replacer
+static constexpr int LRUK_CORRELATED_PERIOD = 16;                             // lru-k correlated period, in unpins
+static constexpr int TWO_QUEUE_A1IN_PERCENT = 25;                             // 2q probation queue share of the pool
+static constexpr int TWO_QUEUE_A1OUT_PERCENT = 50;                            // 2q ghost queue length, % of the pool
+static constexpr int SCAN_RING_SIZE = 32;                                      // max frames a sequential scan recycles
+static constexpr int PREFETCH_QUEUE_SIZE = 64;                                 // max pending read-ahead requests
+static constexpr int PAGE_CLEANER_INTERVAL = 10;                               // page cleaner wake-up period, in ms
+static constexpr int PAGE_CLEANER_LOW_WATERMARK = 5;                           // % clean frames that wakes the cleaner
+static constexpr int PAGE_CLEANER_HIGH_WATERMARK = 10;                         // % clean frames the cleaner aims for
+static constexpr int IO_URING_QUEUE_DEPTH = 64;                                // max requests in flight on an io_uring
+static constexpr int EXTENT_SIZE = 64;                                         // contiguous pages reserved at a time
+static constexpr int SCRUBBER_INTERVAL = 60000;                                // pause between two scrubs, in ms
+
+// Pages are read and written with direct I/O, which needs multiples of the 4 KB blocks of the device, and the slots
+// of compressed pages and the back references of the codec reach at most 64 KB.
+static_assert(PAGE_SIZE >= 4096 && PAGE_SIZE <= 32768, "PAGE_SIZE must be between 4 KB and 32 KB");
+static_assert((PAGE_SIZE & (PAGE_SIZE - 1)) == 0, "PAGE_SIZE must be a power of two");
+static_assert(HUGE_PAGE_SIZE % PAGE_SIZE == 0, "a huge page must hold whole pages");
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
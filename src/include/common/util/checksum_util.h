@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// checksum_util.h
+//
+// Identification: src/include/common/util/checksum_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * ChecksumUtil computes checksums that detect corrupted data, e.g. a page that was torn by a crash during its write.
+ */
+class ChecksumUtil {
+ public:
+  /**
+   * Compute the CRC-32C (Castagnoli) of a byte range, with the crc32 instruction of SSE 4.2 if the CPU has it.
+   * @param data start of the range
+   * @param size size of the range, in byte
+   * @param crc the CRC-32C of the data preceding the range, to continue from
+   * @return the CRC-32C of the data
+   */
+  static uint32_t Crc32c(const char *data, size_t size, uint32_t crc = 0);
+
+  /** @return true if Crc32c uses the crc32 instruction */
+  static bool HasHardwareCrc32c();
+};
+
+}  // namespace bustub
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * CompressionUtil compresses pages with a fast LZ77 codec, in the block format of LZ4: a sequence of literal runs,
+ * each followed by a back reference of at least 4 bytes into the last 64 KB. Compression finds matches through a hash
+ * table of 4-byte sequences and takes the first one, trading ratio for speed, like LZ4 at its default level.
+ */
+class CompressionUtil {
+ public:
+  /**
+   * Compress a byte range.
+   * @param src start of the range
+   * @param size size of the range, in byte
+   * @param[out] dst output buffer
+   * @param capacity size of the output buffer, in byte
+   * @return the size of the compressed data, 0 if it does not fit in the output buffer
+   */
+  static size_t Compress(const char *src, size_t size, char *dst, size_t capacity);
+
+  /**
+   * Decompress data compressed by Compress.
+   * @param src start of the compressed data
+   * @param size size of the compressed data, in byte
+   * @param[out] dst output buffer
+   * @param dst_size size of the decompressed data, in byte
+   * @return false if the compressed data is malformed or does not decompress to exactly dst_size bytes
+   */
+  static bool Decompress(const char *src, size_t size, char *dst, size_t dst_size);
+};
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 #include "storage/table/tuple.h"
@@ -32,6 +33,8 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** The whole contents of a page, written by a bulk load instead of a record per tuple. */
+  PAGEIMAGE,
 };
 
 /**
@@ -57,6 +60,10 @@ enum class LogRecordType {
  *--------------------------
  * | HEADER | prev_page_id |
  *--------------------------
+ * For page image type log record
+ *-----------------------------------------
+ * | HEADER | page_id | page_data (PAGE_SIZE) |
+ *-----------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -110,6 +117,17 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(page_id_t) * 2;
   }
 
+  // constructor for PAGEIMAGE type
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t page_id, const char *page_data)
+      : txn_id_(txn_id),
+        prev_lsn_(prev_lsn),
+        log_record_type_(log_record_type),
+        page_id_(page_id),
+        page_image_(page_data, page_data + PAGE_SIZE) {
+    // calculate log record size, header size + sizeof(page_id) + PAGE_SIZE
+    size_ = HEADER_SIZE + sizeof(page_id_t) + PAGE_SIZE;
+  }
+
   ~LogRecord() = default;
 
   inline Tuple &GetDeleteTuple() { return delete_tuple_; }
@@ -128,6 +146,10 @@ class LogRecord {
 
   inline page_id_t GetNewPageRecord() { return prev_page_id_; }
 
+  inline page_id_t GetPageImagePageId() { return page_id_; }
+
+  inline const std::vector<char> &GetPageImage() { return page_image_; }
+
   inline int32_t GetSize() { return size_; }
 
   inline lsn_t GetLSN() { return lsn_; }
@@ -176,6 +198,8 @@ class LogRecord {
   // case4: for new page operation
   page_id_t prev_page_id_{INVALID_PAGE_ID};
   page_id_t page_id_{INVALID_PAGE_ID};
+  // case5: for page image operation, page_id_ is the page
+  std::vector<char> page_image_;
   static const int HEADER_SIZE = 20;
 };  // namespace bustub
 
@@ -19,6 +19,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/log_record.h"
+#include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_file.h
+//
+// Identification: src/include/storage/disk/compressed_page_file.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageFile stores the pages of a data file compressed (see CompressionUtil), so that a page takes less of
+ * the disk and of the read bandwidth of a scan than PAGE_SIZE.
+ *
+ * The file is divided into slots of SLOT_SIZE bytes, and a page takes a run of as many slots as its compressed data
+ * needs, at most PAGE_SIZE / SLOT_SIZE; a page that does not compress by at least a slot is stored as is. The slot map,
+ * kept in a file of its own, maps every page to its run. A page that is written again stays in its run if it still
+ * fits, otherwise it moves to a free run of the right size, or to the end of the file, and its old run is freed once
+ * the map points to the new one. Pages that are written in order lie in consecutive runs, so a run of pages can be
+ * read with a single read.
+ */
+class CompressedPageFile {
+ public:
+  /** Size of a slot, in byte. */
+  static constexpr size_t SLOT_SIZE = 512;
+  /** Number of slots of an uncompressed page. */
+  static constexpr size_t SLOTS_PER_PAGE = PAGE_SIZE / SLOT_SIZE;
+  static_assert(PAGE_SIZE % SLOT_SIZE == 0, "a page must take whole slots");
+
+  /**
+   * Open the compressed pages of a data file.
+   * @param fd file descriptor of the data file, open for reading and writing
+   * @param map_file_name the slot map file
+   * @param reset true to discard an existing slot map file because the data file was just created
+   */
+  CompressedPageFile(int fd, std::string map_file_name, bool reset);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageFile);
+
+  /**
+   * Compress a page and write it.
+   * @param page_id position of the page within the data file
+   * @param data the data of the page
+   * @return true if the write succeeded
+   */
+  bool WritePage(page_id_t page_id, const char *data);
+
+  /**
+   * Read a page and decompress it. A page that was never written reads as zeros.
+   * @param page_id position of the page within the data file
+   * @param[out] data output buffer
+   * @return false if the read failed or the page does not decompress
+   */
+  bool ReadPage(page_id_t page_id, char *data);
+
+  /**
+   * Read a run of consecutive pages, with a single read if their slots are close together.
+   * @param page_id position of the first page within the data file
+   * @param[out] data output buffers, one per page
+   * @return false if a read failed or a page does not decompress
+   */
+  bool ReadPages(page_id_t page_id, const std::vector<char *> &data);
+
+  /** @return one past the position of the last page that was written */
+  page_id_t GetNumPages();
+
+  /** @return the number of slots of the data file, used or free */
+  size_t GetNumSlots();
+
+  /** Close the slot map file. */
+  void Close();
+
+ private:
+  /** Where a page is stored. The entries are the records of the slot map file. */
+  struct SlotRun {
+    /** Offset of the run, in slots. */
+    uint32_t first_slot_;
+    /** Size of the stored data, in byte: PAGE_SIZE if the page is stored as is, 0 if the page was never written. */
+    uint32_t size_;
+
+    size_t GetNumSlots() const { return (size_ + SLOT_SIZE - 1) / SLOT_SIZE; }
+  };
+
+  /** Find a free run of slots, at the end of the file if there is none. */
+  uint32_t AllocateSlots(size_t num_slots);
+
+  /** Free a run of slots. */
+  void FreeSlots(uint32_t first_slot, size_t num_slots);
+
+  /** Decompress the stored data of a page. */
+  static bool DecodePage(const SlotRun &run, const char *stored, char *data);
+
+  /** Write the slot map entry of a page to the slot map file. */
+  void WriteSlotRun(page_id_t page_id);
+
+  /** File descriptor of the data file. */
+  const int fd_;
+  /** Protects everything below. */
+  std::mutex latch_;
+  /** Slot run of every page, indexed by position. */
+  std::vector<SlotRun> slot_map_;
+  /** First slot of the free runs, by their number of slots. Runs longer than a page are kept as runs of a page. */
+  std::vector<std::vector<uint32_t>> free_slots_;
+  /** Every slot below this one is used or free. */
+  uint32_t end_slot_{0};
+  /** Stream of the slot map file. */
+  std::fstream map_io_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_backend.h
+//
+// Identification: src/include/storage/disk/disk_backend.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The ways a DiskManager can read and write pages of the database file. */
+enum class DiskBackendType {
+  /** Seek and read or write through a file stream, one request at a time. */
+  STREAM,
+  /** Asynchronous reads and writes through an io_uring (IoUringDiskBackend), many requests in flight at once. */
+  IO_URING,
+  /** Positional reads and writes that bypass the page cache (PosixDiskBackend), one request per calling thread. */
+  POSIX,
+};
+
+/**
+ * DiskRequest is a read or write of one page of the database file.
+ */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_;
+  /** Page to read or write. */
+  page_id_t page_id_;
+  /** The page data to write, or the buffer to read it into. Must stay valid until the request completes. */
+  char *data_;
+  /** Set once the request has completed, to true if it succeeded. */
+  std::promise<bool> callback_;
+};
+
+/**
+ * DiskBackend performs the page reads and writes of a DiskManager. A backend may complete requests asynchronously,
+ * from a thread of its own, and may have many requests in flight at once. A read past the end of the file reads zeros.
+ */
+class DiskBackend {
+ public:
+  virtual ~DiskBackend() = default;
+
+  /**
+   * Start a request. Its callback is set once the request has completed.
+   * @param request the request to perform
+   */
+  virtual void Schedule(DiskRequest request) = 0;
+
+  /**
+   * Write a batch of pages and wait for the writes to complete. By default every page is scheduled before waiting for
+   * any of them; a backend can do better by writing runs of consecutive pages at once.
+   * @param pages the pages to write with their data, sorted by page id
+   * @return true if every write succeeded
+   */
+  virtual bool WritePages(const std::vector<std::pair<page_id_t, char *>> &pages);
+
+  /**
+   * Register a memory area that pages will be read into and written from, e.g. the frames of a buffer pool, so that
+   * the backend can set it up for I/O once rather than on every request.
+   * @param data start of the area
+   * @param size size of the area, in byte
+   * @return true if the area was registered; the caller must then unregister it before unmapping it
+   */
+  virtual bool RegisterBuffer(char *data, size_t size) { return false; }
+
+  /**
+   * Unregister a memory area.
+   * @param data start of the area
+   */
+  virtual void UnregisterBuffer(char *data) {}
+};
+
+}  // namespace bustub
@@ -12,28 +12,68 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
 #include <fstream>
-#include <future>  // NOLINT
+#include <future>              // NOLINT
+#include <memory>
+#include <mutex>               // NOLINT
 #include <string>
+#include <thread>              // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/compressed_page_file.h"
+#include "storage/disk/disk_backend.h"
+#include "storage/disk/free_page_bitmap.h"
+#include "storage/disk/page_checksums.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The pages of a database live in one or more data files, its tablespace. With several data files, the pages are
+ * striped over the files in runs of EXTENT_SIZE pages: an extent lies in one file, and consecutive extents lie in
+ * consecutive files, so that the I/O of a scan is spread over files on different devices. Every data file is read and
+ * written through its own file stream, or its own DiskBackend that can have many requests in flight.
+ *
+ * Every page is checksummed when it is written (see PageChecksums) and verified when it is read. A page that fails
+ * verification is counted and logged, and a background scrubber can verify the whole database ahead of the reads.
+ *
+ * The data files can store their pages compressed (see CompressedPageFile), e.g. for a database that is mostly read
+ * by scans, so that a page occupies less of the disk and of its bandwidth. Compressed data files are read and written
+ * synchronously, whatever the backend type. A data file must be opened compressed, or not, every time.
+ *
+ * For read-mostly databases the data files can also be mapped into memory read-only (see MapDataFiles). A buffer pool
+ * then points its frames at the pages in the mapping instead of copying them, and the kernel keeps the cold pages.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param backend_type how pages are read and written; falls back to STREAM if the backend is not supported
+   */
+  explicit DiskManager(const std::string &db_file, DiskBackendType backend_type = DiskBackendType::STREAM);
+
+  /**
+   * Creates a new disk manager that spreads the pages of the database over several data files.
+   * @param data_files the file names of the data files, in striping order; the first one also names the log file
+   * @param max_pages_per_file the most pages a data file may hold, rounded down to a multiple of EXTENT_SIZE; 0 for no
+   * limit. Pages are not allocated past the limit.
+   * @param backend_type how pages are read and written; falls back to STREAM if the backend is not supported
+   * @param compress_pages true to store the pages of the data files compressed
    */
-  explicit DiskManager(const std::string &db_file);
+  DiskManager(const std::vector<std::string> &data_files, page_id_t max_pages_per_file = 0,
+              DiskBackendType backend_type = DiskBackendType::STREAM, bool compress_pages = false);
 
-  ~DiskManager() = default;
+  ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -54,6 +94,57 @@ class DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read a run of consecutive pages from the database file with a single seek and read.
+   * @param page_id id of the first page
+   * @param[out] page_data output buffers, one per page
+   */
+  void ReadPages(page_id_t page_id, const std::vector<char *> &page_data);
+
+  /**
+   * Write a batch of pages to the database file, e.g. every page of a buffer pool at a checkpoint, and sync the file
+   * once all of them are written. The pages are written in page id order and runs of consecutive pages are written
+   * together.
+   * @param pages the pages to write with their data, in any order
+   */
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> pages);
+
+  /**
+   * Start writing a page to the database file. The page data must not change until the write has completed.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   * @return a future that becomes ready, with true if the write succeeded, once the write has completed
+   */
+  std::future<bool> WritePageAsync(page_id_t page_id, const char *page_data);
+
+  /**
+   * Start reading a page from the database file.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the read has completed
+   * @return a future that becomes ready, with true if the read succeeded, once the read has completed
+   */
+  std::future<bool> ReadPageAsync(page_id_t page_id, char *page_data);
+
+  /**
+   * Let the backend set up a memory area that pages are read into and written from once, e.g. the frames of a buffer
+   * pool. The area must be unregistered before it is unmapped, and before the disk manager is shut down.
+   * @param data start of the area
+   * @param size size of the area, in byte
+   * @return true if the area was registered, false if the backend does not benefit from registration
+   */
+  bool RegisterBuffer(char *data, size_t size);
+
+  /**
+   * Unregister a memory area registered with RegisterBuffer.
+   * @param data start of the area
+   */
+  void UnregisterBuffer(char *data);
+
+  /** @return how pages are read and written */
+  DiskBackendType GetBackendType() const {
+    return data_files_[0]->backend_ == nullptr ? DiskBackendType::STREAM : backend_type_;
+  }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -71,17 +162,29 @@ class DiskManager {
   bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
-   * @return the id of the allocated page
+   * Allocate a page on disk, reusing the lowest deallocated page id if there is one.
+   * @param stride only allocate page ids that are congruent to offset modulo stride
+   * @param offset only allocate page ids that are congruent to offset modulo stride
+   * @return the id of the allocated page, INVALID_PAGE_ID if the data files are full
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(uint32_t stride = 1, uint32_t offset = 0);
 
   /**
-   * Deallocate a page on disk.
+   * Allocate a run of contiguous pages on disk, aligned to its size.
+   * @param num_pages the number of pages in the run
+   * @return the id of the first page of the run, INVALID_PAGE_ID if the data files are full
+   */
+  page_id_t AllocateExtent(uint32_t num_pages);
+
+  /**
+   * Deallocate a page on disk, so that its page id can be allocated again.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(page_id_t page_id);
 
+  /** @return true if the page is allocated on disk */
+  bool IsAllocated(page_id_t page_id);
+
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
 
@@ -91,6 +194,64 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of page reads */
+  int GetNumReads() const;
+
+  /** @return the number of pages that failed checksum verification, when they were read or scrubbed */
+  int GetNumCorruptPages() const { return num_corrupt_pages_; }
+
+  /**
+   * Verify the checksum of every page of the data files. The files are read in large sequential reads of their own,
+   * past the streams and backends, so that scrubbing runs at the bandwidth of the disks. Corrupt pages are counted
+   * like corrupt pages found by ReadPage.
+   * @return the number of corrupt pages found
+   */
+  int ScrubPages();
+
+  /**
+   * Start a background thread that scrubs the data files, then again after every interval. Does nothing if the
+   * scrubber is already running.
+   * @param interval pause between two scrubs of the data files
+   */
+  void RunScrubber(std::chrono::milliseconds interval = std::chrono::milliseconds(SCRUBBER_INTERVAL));
+
+  /** Stop the scrubber thread, if it is running. */
+  void StopScrubber();
+
+  /** @return the number of data files the pages are striped over */
+  size_t GetNumDataFiles() const { return data_files_.size(); }
+
+  /** @return the file name of a data file */
+  const std::string &GetDataFileName(size_t file_index) const { return data_files_[file_index]->name_; }
+
+  /** @return the number of page writes to a data file */
+  int GetNumWrites(size_t file_index) const { return data_files_[file_index]->num_writes_; }
+
+  /** @return the number of page reads from a data file */
+  int GetNumReads(size_t file_index) const { return data_files_[file_index]->num_reads_; }
+
+  /** @return true if the pages of the data files are stored compressed */
+  bool IsCompressed() const { return compress_pages_; }
+
+  /**
+   * Map the data files into memory read-only, as far as they reach now, so that their pages can be read without a
+   * copy through ReadMappedPage. Pages written later still reach the mapping if they lie within it. Compressed data
+   * files cannot be mapped.
+   * @return true if the data files were mapped
+   */
+  bool MapDataFiles();
+
+  /** @return true if the data files are mapped into memory */
+  bool IsMapped() const { return mapped_; }
+
+  /**
+   * Read a page from the memory mapping of its data file, verifying it like ReadPage.
+   * @param page_id id of the page
+   * @return the page in the mapping, which must not be modified and is only valid until the disk manager is shut down;
+   * nullptr if the page lies outside the mapping
+   */
+  const char *ReadMappedPage(page_id_t page_id);
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -101,16 +262,69 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
-  int GetFileSize(const std::string &file_name);
+  /** A data file of the tablespace. */
+  struct DataFile {
+    std::string name_;
+    // stream to read and write the file
+    std::fstream io_;
+    // protects io_, the stream cursor is shared by every reader and writer
+    std::mutex io_latch_;
+    // backend that reads and writes pages instead of io_, nullptr for the stream
+    std::unique_ptr<DiskBackend> backend_;
+    // file descriptor of the file for backend_ or compressed_
+    int fd_{-1};
+    // compressed pages of the file, which replace io_ and backend_; nullptr if the pages are not compressed
+    std::unique_ptr<CompressedPageFile> compressed_;
+    // read-only memory mapping of the file, nullptr if it is not mapped
+    char *map_data_{nullptr};
+    // size of map_data_, in byte
+    size_t map_size_{0};
+    std::atomic<int> num_writes_{0};
+    std::atomic<int> num_reads_{0};
+  };
+
+  // open a data file with its stream and backend, creating it if it does not exist; returns true if it was created
+  bool OpenDataFile(DataFile *file);
+  // close a data file
+  void CloseDataFile(DataFile *file);
+  // unmap a data file, if it is mapped
+  void UnmapDataFile(DataFile *file);
+  // find the index of the data file of a page, and the position of the page within the file
+  size_t LocatePage(page_id_t page_id, page_id_t *file_page_id) const;
+  // the id of the page at a position within a data file
+  page_id_t GetPageId(size_t file_index, page_id_t file_page_id) const;
+  off_t GetFileSize(const std::string &file_name);
+  // write a data file's data through to the disk
+  void SyncFile(DataFile *file);
+  // read a page through the stream, or the compressed pages, of its data file; returns false if the read failed or the
+  // page is corrupt
+  bool ReadPageFromStream(page_id_t page_id, char *page_data);
+  // verify the checksum of a page that was read, counting and logging it if it is corrupt
+  bool VerifyPage(page_id_t page_id, const char *page_data);
+  // verify a page that failed verification while scrubbing again, in case a write of the page was in flight; fd is the
+  // data file opened for scrubbing, unused if its pages are compressed
+  bool RecheckPage(size_t file_index, int fd, page_id_t file_page_id);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
-  std::string file_name_;
-  std::atomic<page_id_t> next_page_id_;
+  // data files, in striping order
+  std::vector<std::unique_ptr<DataFile>> data_files_;
+  DiskBackendType backend_type_;
+  bool compress_pages_;
+  bool mapped_{false};
+  // tracks the allocated pages of the data files
+  std::unique_ptr<FreePageBitmap> free_pages_;
+  // checksums of the pages of the data files
+  std::unique_ptr<PageChecksums> checksums_;
+  std::atomic<int> num_corrupt_pages_{0};
+  // background thread running ScrubPages
+  std::thread scrubber_thread_;
+  // protects scrubber_thread_
+  std::mutex scrubber_latch_;
+  std::condition_variable scrubber_cv_;
+  // set to stop the scrubber, also in the middle of a scrub
+  std::atomic<bool> scrubber_shutdown_{false};
   int num_flushes_;
-  int num_writes_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
 };
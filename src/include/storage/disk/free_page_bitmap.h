@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_bitmap.h
+//
+// Identification: src/include/storage/disk/free_page_bitmap.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FreePageBitmap tracks which pages of a database file are allocated, so that deallocated pages are handed out again
+ * instead of growing the file forever.
+ *
+ * There is one bit per page id, set while the page is allocated. Allocation returns the lowest free page id, which
+ * keeps the file compact. Runs of contiguous pages are allocated at a multiple of their size, above every page
+ * allocated so far if there is no free run below.
+ *
+ * The bitmap is kept in its own file of bitmap pages, each page covering BITS_PER_BITMAP_PAGE page ids, like the free
+ * space map fork of a table in PostgreSQL. The database file keeps its page ids, so page 0 stays the header page. As
+ * long as no page has been deallocated, nothing is lost by treating every page of the database file as allocated when
+ * it is opened again, at worst the free pages below a run stay unused. So the bitmap file is only created by the first
+ * deallocation, and every change after that is written through to the bitmap pages that hold the bits.
+ */
+class FreePageBitmap {
+ public:
+  /** Number of page ids one bitmap page covers. */
+  static constexpr page_id_t BITS_PER_BITMAP_PAGE = PAGE_SIZE * 8;
+
+  /**
+   * Load the bitmap of a database file.
+   * @param file_name the bitmap file, empty to keep the bitmap in memory only
+   * @param num_pages the number of pages of the database file, which are allocated if there is no bitmap file
+   * @param reset true to discard an existing bitmap file because the database file was just created
+   * @param capacity the number of page ids that can be allocated
+   */
+  FreePageBitmap(std::string file_name, page_id_t num_pages, bool reset,
+                 page_id_t capacity = std::numeric_limits<page_id_t>::max());
+
+  DISALLOW_COPY_AND_MOVE(FreePageBitmap);
+
+  /**
+   * Allocate the lowest free page id that is congruent to offset modulo stride. The stride lets the instances of a
+   * parallel buffer pool allocate the page ids they own.
+   * @param stride the stride of the page ids to choose from
+   * @param offset the offset of the page ids to choose from, below stride
+   * @return the allocated page id, INVALID_PAGE_ID if every page id below the capacity is allocated
+   */
+  page_id_t Allocate(uint32_t stride = 1, uint32_t offset = 0);
+
+  /**
+   * Allocate the lowest run of contiguous free page ids that starts at a multiple of its size.
+   * @param num_pages the number of page ids in the run
+   * @return the first page id of the run, INVALID_PAGE_ID if there is no free run below the capacity
+   */
+  page_id_t AllocateExtent(uint32_t num_pages);
+
+  /**
+   * Free a page id. Does nothing if the page id is not allocated.
+   * @param page_id the page id to free
+   */
+  void Deallocate(page_id_t page_id);
+
+  /** @return true if the page id is allocated */
+  bool IsAllocated(page_id_t page_id);
+
+  /** Make the bitmap file durable, so that it is not older than the data files it describes after a crash. */
+  void Sync();
+
+  /** Close the bitmap file. */
+  void Close();
+
+ private:
+  static constexpr size_t BITS_PER_WORD = 64;
+  static constexpr size_t WORDS_PER_BITMAP_PAGE = BITS_PER_BITMAP_PAGE / BITS_PER_WORD;
+
+  bool TestBit(page_id_t page_id) const;
+
+  /** Set or clear the bits of a run of page ids, growing the bitmap if needed, and write their bitmap pages through. */
+  void UpdateBits(page_id_t first_page_id, uint32_t num_pages, bool allocated);
+
+  /** Write a bitmap page to the bitmap file, creating the file if needed. */
+  void WriteBitmapPage(size_t bitmap_page);
+
+  /** Bitmap file, empty if the bitmap is not persisted. */
+  const std::string file_name_;
+  /** Every allocated page id is below this one. */
+  const page_id_t capacity_;
+  /** Protects everything below. */
+  std::mutex latch_;
+  /** One bit per page id, set if the page is allocated. */
+  std::vector<uint64_t> words_;
+  /** Every word below this one is full. */
+  size_t first_free_word_{0};
+  /** Stream of the bitmap file, open once the file exists. */
+  std::fstream io_;
+};
+
+}  // namespace bustub
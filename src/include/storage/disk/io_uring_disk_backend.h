@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring_disk_backend.h
+//
+// Identification: src/include/storage/disk/io_uring_disk_backend.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_backend.h"
+
+namespace bustub {
+
+/**
+ * IoUringDiskBackend reads and writes pages through a Linux io_uring.
+ *
+ * Schedule puts a request on the submission queue and returns right away; a completion thread reaps the completion
+ * queue and sets the callbacks. A short transfer is legal for io_uring, the completion thread resubmits the rest of
+ * the page until the whole page is transferred or a read reaches the end of the file. Up to queue_depth requests are
+ * in flight at once, Schedule waits for a free slot beyond that. Reads into and writes from registered buffers use the fixed-buffer variants of the operations, which
+ * saves the kernel from mapping the pages of the buffer on every request.
+ *
+ * The ring is driven with raw system calls, so the build does not depend on liburing.
+ */
+class IoUringDiskBackend : public DiskBackend {
+ public:
+  /**
+   * Set up an io_uring for a file. Throws an Exception if the kernel does not support io_uring.
+   * @param fd the file to read and write, which stays owned by the caller
+   * @param queue_depth the maximum number of requests in flight
+   */
+  explicit IoUringDiskBackend(int fd, unsigned queue_depth = IO_URING_QUEUE_DEPTH);
+
+  /** Wait for the requests in flight, then tear down the ring. */
+  ~IoUringDiskBackend() override;
+
+  DISALLOW_COPY_AND_MOVE(IoUringDiskBackend);
+
+  void Schedule(DiskRequest request) override;
+
+  bool RegisterBuffer(char *data, size_t size) override;
+
+  void UnregisterBuffer(char *data) override;
+
+ private:
+  /** A request in flight, with the number of bytes transferred so far. */
+  struct PendingRequest {
+    DiskRequest request_;
+    uint32_t num_done_{0};
+  };
+
+  /** Body of the completion thread: reap completions until the shutdown request comes back. */
+  void RunCompletions();
+
+  /**
+   * Handle the completion of an operation of a request, resubmitting the rest of the page after a short transfer.
+   * @param pending the request
+   * @param res the result of the operation
+   * @return true if the request is complete and its slot is free, false if it was resubmitted
+   */
+  bool Complete(PendingRequest *pending, int res);
+
+  /**
+   * Put one operation on the submission queue and submit it. Must be called with latch_ held and a free slot. The
+   * operation transfers the part of the page the request has not transferred yet.
+   * @param opcode the operation
+   * @param pending the request to complete once the operation has completed, nullptr for the shutdown request
+   */
+  void Submit(uint8_t opcode, PendingRequest *pending);
+
+  /** Register the buffers in buffers_ with the ring, replacing the previous registration. Called with latch_ held. */
+  bool UpdateRegisteredBuffers();
+
+  /** File that is read and written. */
+  const int fd_;
+  /** The io_uring. */
+  int ring_fd_{-1};
+  /** Number of entries of the submission queue, the maximum number of requests in flight. */
+  unsigned sq_entries_;
+
+  /** Mapping of the submission queue ring, and of the completion queue ring if the kernel maps them together. */
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  /** Mapping of the completion queue ring, if it is separate. */
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  /** Mapping of the submission queue entries. */
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  unsigned *sq_tail_;
+  unsigned *sq_mask_;
+  unsigned *sq_array_;
+  unsigned *cq_head_;
+  unsigned *cq_tail_;
+  unsigned *cq_mask_;
+  io_uring_cqe *cqes_;
+
+  /** Protects the submission queue, in_flight_ and the buffer registration. */
+  std::mutex latch_;
+  /** Signalled when a request completes. */
+  std::condition_variable slot_freed_;
+  /** Number of requests in flight. */
+  unsigned in_flight_{0};
+  /** Registered buffers, in the order of their index in the ring's buffer table. */
+  std::vector<iovec> buffers_;
+  /** Reaps completions. */
+  std::thread completion_thread_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_checksums.h
+//
+// Identification: src/include/storage/disk/page_checksums.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageChecksums keeps a CRC-32C of every page of a database, so that a page that was torn by a crash during its write,
+ * or that was corrupted on disk, is detected when it is read.
+ *
+ * Every page type uses all of PAGE_SIZE for itself, e.g. the tuples of a table page grow down from the end of the page,
+ * so the checksums cannot live in the pages. They are kept in a file of their own instead, one 4-byte checksum per page
+ * id, next to the free page bitmap. A page is checksummed before it is written and the checksum is written through to
+ * the file. A checksum of 0 means that the page has none, because it was never written or was written before its
+ * database kept checksums, and such a page is not verified.
+ */
+class PageChecksums {
+ public:
+  /**
+   * Load the checksums of a database.
+   * @param file_name the checksum file, empty to keep the checksums in memory only
+   * @param reset true to discard an existing checksum file because the database file was just created
+   */
+  PageChecksums(std::string file_name, bool reset);
+
+  DISALLOW_COPY_AND_MOVE(PageChecksums);
+
+  /**
+   * Checksum a page that is about to be written.
+   * @param page_id id of the page
+   * @param data the data of the page
+   */
+  void Update(page_id_t page_id, const char *data);
+
+  /**
+   * Checksum a batch of pages that are about to be written, writing the checksums of consecutive pages together.
+   * @param pages the pages with their data, sorted by page id
+   */
+  void Update(const std::vector<std::pair<page_id_t, const char *>> &pages);
+
+  /**
+   * Verify a page that was read.
+   * @param page_id id of the page
+   * @param data the data that was read
+   * @return false if the page has a checksum that does not match the data
+   */
+  bool Verify(page_id_t page_id, const char *data);
+
+  /** Make the checksum file durable, before the data files whose checksums it holds are synced. */
+  void Sync();
+
+  /** Close the checksum file. */
+  void Close();
+
+ private:
+  /** @return the checksum of page data, never 0 */
+  static uint32_t Compute(const char *data);
+
+  /** Write the checksums of a run of consecutive pages to the checksum file. */
+  void WriteChecksums(page_id_t first_page_id, size_t num_pages);
+
+  /** Checksum file, empty if the checksums are not persisted. */
+  const std::string file_name_;
+  /** Protects everything below. */
+  std::mutex latch_;
+  /** Checksum of every page, indexed by page id. */
+  std::vector<uint32_t> checksums_;
+  /** Stream of the checksum file. */
+  std::fstream io_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posix_disk_backend.h
+//
+// Identification: src/include/storage/disk/posix_disk_backend.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_backend.h"
+
+namespace bustub {
+
+/**
+ * PosixDiskBackend reads and writes pages with pread and pwrite at page_id * PAGE_SIZE.
+ *
+ * There is no shared file cursor, so threads read and write pages in parallel. Requests are performed in the calling
+ * thread and have completed when Schedule returns. The file is expected to be opened with O_DIRECT, which requires
+ * page-aligned buffers: the frames of a buffer pool are, other buffers are copied through an aligned bounce buffer.
+ */
+class PosixDiskBackend : public DiskBackend {
+ public:
+  /**
+   * Create a backend for a file.
+   * @param fd the file to read and write, which stays owned by the caller
+   */
+  explicit PosixDiskBackend(int fd) : fd_(fd) {}
+
+  DISALLOW_COPY_AND_MOVE(PosixDiskBackend);
+
+  void Schedule(DiskRequest request) override;
+
+  /** Write each run of consecutive, page-aligned pages with as few pwritev calls as possible. */
+  bool WritePages(const std::vector<std::pair<page_id_t, char *>> &pages) override;
+
+ private:
+  /**
+   * Read or write a page from or to a page-aligned buffer.
+   * @return true if the request succeeded
+   */
+  bool Transfer(bool is_write, page_id_t page_id, char *data);
+
+  /**
+   * Write a run of consecutive pages from page-aligned buffers.
+   * @param page_id id of the first page
+   * @param page_data the data of the pages, consumed by the call
+   * @return true if the write succeeded
+   */
+  bool WriteRun(page_id_t page_id, std::vector<iovec> *page_data);
+
+  /** File that is read and written. */
+  const int fd_;
+};
+
+}  // namespace bustub
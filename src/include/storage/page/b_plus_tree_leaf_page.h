@@ -64,6 +64,8 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
  private:
+  static_assert(LEAF_PAGE_SIZE >= 4, "a leaf page must hold enough entries to split");
+
   void CopyNFrom(MappingType *items, int size);
   void CopyLastFrom(const MappingType &item);
   void CopyFirstFrom(const MappingType &item);
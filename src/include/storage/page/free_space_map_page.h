@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * A page of the free space map of a table heap (see FreeSpaceMap). It records, for a run of the pages of the heap, how
+ * much space each one has free, in one of 256 categories of PAGE_SIZE / 256 bytes.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | EntryCount (4) | MaxCategory (4) |
+ *  ------------------------------------------------------------------------------------
+ *  -------------------------------------------------------------------------------------------
+ *  | TablePageId_1 (4) | ... | TablePageId_CAPACITY (4) | Category_1 (1) | ... | Category_CAPACITY (1) |
+ *  -------------------------------------------------------------------------------------------
+ *
+ * MaxCategory is the highest category of the page, so that a search can skip pages without enough free space.
+ */
+class FreeSpaceMapPage : public Page {
+ public:
+  /** Number of bytes of free space per category. */
+  static constexpr uint32_t CATEGORY_SIZE = PAGE_SIZE / 256;
+
+  /** Number of table pages a map page covers. */
+  static constexpr uint32_t CAPACITY = (PAGE_SIZE - 20) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+  /** @return the category of a page with the given free space, which has at least that many categories free */
+  static uint8_t ToCategory(uint32_t free_space) { return std::min<uint32_t>(free_space / CATEGORY_SIZE, 255); }
+
+  /** @return the lowest category of pages that certainly have size bytes free, above 255 if no category has */
+  static uint32_t ToMinCategory(uint32_t size) { return (size + CATEGORY_SIZE - 1) / CATEGORY_SIZE; }
+
+  /** Initialize an empty map page. */
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetUint32(OFFSET_ENTRY_COUNT, 0);
+    SetUint32(OFFSET_MAX_CATEGORY, 0);
+  }
+
+  /** @return the page id of the next map page */
+  page_id_t GetNextPageId() const { return *reinterpret_cast<const page_id_t *>(Data() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the next map page. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of table pages recorded in this page */
+  uint32_t GetEntryCount() const { return GetUint32(OFFSET_ENTRY_COUNT); }
+
+  /** @return the highest category of this page */
+  uint32_t GetMaxCategory() const { return GetUint32(OFFSET_MAX_CATEGORY); }
+
+  /** @return the table page of an entry */
+  page_id_t GetTablePageId(uint32_t index) const {
+    return *reinterpret_cast<const page_id_t *>(Data() + OFFSET_TABLE_PAGE_IDS + index * sizeof(page_id_t));
+  }
+
+  /** @return the category of an entry */
+  uint8_t GetCategory(uint32_t index) const {
+    return *reinterpret_cast<const uint8_t *>(Data() + OFFSET_CATEGORIES + index);
+  }
+
+  /**
+   * Record a table page at the end of this page.
+   * @return false if the page is full
+   */
+  bool Append(page_id_t table_page_id, uint32_t free_space) {
+    uint32_t index = GetEntryCount();
+    if (index == CAPACITY) {
+      return false;
+    }
+    memcpy(GetData() + OFFSET_TABLE_PAGE_IDS + index * sizeof(page_id_t), &table_page_id, sizeof(page_id_t));
+    SetUint32(OFFSET_ENTRY_COUNT, index + 1);
+    SetCategory(index, ToCategory(free_space));
+    return true;
+  }
+
+  /** Clear an entry whose table page was removed from the table, no search finds it anymore. */
+  void Remove(uint32_t index) {
+    page_id_t invalid_page_id = INVALID_PAGE_ID;
+    memcpy(GetData() + OFFSET_TABLE_PAGE_IDS + index * sizeof(page_id_t), &invalid_page_id, sizeof(page_id_t));
+    SetCategory(index, 0);
+  }
+
+  /** Record the free space of the table page of an entry. */
+  void SetFreeSpace(uint32_t index, uint32_t free_space) { SetCategory(index, ToCategory(free_space)); }
+
+  /**
+   * Find the first entry at or after start whose category is at least min_category.
+   * @return the index of the entry, GetEntryCount() if there is none
+   */
+  uint32_t Find(uint32_t min_category, uint32_t start = 0) const {
+    if (GetMaxCategory() < min_category) {
+      return GetEntryCount();
+    }
+    const auto *categories = reinterpret_cast<const uint8_t *>(Data() + OFFSET_CATEGORIES);
+    uint32_t index = start;
+    while (index < GetEntryCount() && categories[index] < min_category) {
+      index++;
+    }
+    return index;
+  }
+
+  /**
+   * Find the entry of a table page.
+   * @return the index of the entry, GetEntryCount() if the table page is not recorded in this page
+   */
+  uint32_t IndexOf(page_id_t table_page_id) const {
+    uint32_t index = 0;
+    while (index < GetEntryCount() && GetTablePageId(index) != table_page_id) {
+      index++;
+    }
+    return index;
+  }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_ENTRY_COUNT = 12;
+  static constexpr size_t OFFSET_MAX_CATEGORY = 16;
+  static constexpr size_t OFFSET_TABLE_PAGE_IDS = 20;
+  static constexpr size_t OFFSET_CATEGORIES = OFFSET_TABLE_PAGE_IDS + CAPACITY * sizeof(page_id_t);
+  static_assert(OFFSET_CATEGORIES + CAPACITY <= PAGE_SIZE);
+
+  const char *Data() const { return const_cast<FreeSpaceMapPage *>(this)->GetData(); }
+
+  uint32_t GetUint32(size_t offset) const { return *reinterpret_cast<const uint32_t *>(Data() + offset); }
+
+  void SetUint32(size_t offset, uint32_t value) { memcpy(GetData() + offset, &value, sizeof(value)); }
+
+  void SetCategory(uint32_t index, uint8_t category) {
+    auto *categories = reinterpret_cast<uint8_t *>(GetData() + OFFSET_CATEGORIES);
+    uint8_t old_category = categories[index];
+    categories[index] = category;
+    if (category >= GetMaxCategory()) {
+      SetUint32(OFFSET_MAX_CATEGORY, category);
+    } else if (old_category == GetMaxCategory()) {
+      // The entry may have been the only one with the highest category.
+      SetUint32(OFFSET_MAX_CATEGORY, *std::max_element(categories, categories + GetEntryCount()));
+    }
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * A page of a value stored out of line by a table heap. A value too large to keep in its tuple is split over a chain
+ * of overflow pages, and the tuple only keeps the id of the first page and the length of the value.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------------------
+ *  | PageId (4) | LSN (4) | NextPageId (4) | DataSize (4) | Data ... |
+ *  ---------------------------------------------------------------------
+ */
+class OverflowPage : public Page {
+ public:
+  /** Number of bytes of a value one overflow page holds. */
+  static constexpr uint32_t CAPACITY = PAGE_SIZE - 16;
+
+  /**
+   * Initialize the page with a part of a value.
+   * @param page_id the page id of this page
+   * @param data the part of the value
+   * @param size the size of the part, at most CAPACITY
+   */
+  void Init(page_id_t page_id, const char *data, uint32_t size) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(size));
+    memcpy(GetData() + OFFSET_DATA, data, size);
+  }
+
+  /** @return the page id of the next page of the value, INVALID_PAGE_ID if this is the last one */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the next page of the value. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of bytes of the value in this page */
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  /** @return the part of the value in this page */
+  const char *GetValueData() { return GetData() + OFFSET_DATA; }
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+  static constexpr size_t OFFSET_DATA = 16;
+};
+
+}  // namespace bustub
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,14 +26,20 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The data of a buffer pool frame lives in the pool's FrameArena, apart from the book-keeping, so that the data is
+ * page-aligned and each Page takes up whole cache lines. A Page that is created on its own allocates its own data. A
+ * frame of a buffer pool over memory-mapped data files may point at its page in the mapping instead. Such a page is
+ * read-only, so taking its write latch first copies it into the frame's own data.
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
+  friend class FrameArena;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. Allocates and zeros out the page data. */
+  Page() : owned_data_(new char[PAGE_SIZE]), data_(owned_data_.get()), frame_data_(data_) { ResetMemory(); }
 
   /** Default destructor. */
   ~Page() = default;
@@ -42,14 +50,23 @@ class Page {
   /** @return the page id of this page */
   inline page_id_t GetPageId() { return page_id_; }
 
-  /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  /** @return the pin count of this page, frames that do not hold a page report 0 */
+  inline int GetPinCount() {
+    int pin_count = pin_count_;
+    return pin_count < 0 ? 0 : pin_count;
+  }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. A page that points into a read-only memory mapping is copied out of it first. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    if (data_ != frame_data_) {
+      memcpy(frame_data_, data_, PAGE_SIZE);
+      data_ = frame_data_;
+    }
+  }
 
   /** Release the page write latch. */
   inline void WUnlatch() { rwlatch_.WUnlock(); }
@@ -75,17 +92,28 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Create a page whose data is owned by someone else, i.e. a buffer pool frame. Zeros out the page data. */
+  explicit Page(char *data) : data_(data), frame_data_(data) { ResetMemory(); }
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
+  /** The data of the page, if the page allocated it itself. */
+  std::unique_ptr<char[]> owned_data_;
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  char *data_;
+  /** The data that belongs to the page, which data_ points at unless the page is in a memory mapping. */
+  char *frame_data_;
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /**
+   * The pin count of this page. The buffer pool pins resident pages without holding its latch, so the pin count is
+   * updated with compare-and-swap. A negative pin count means the frame is free or being (re)loaded and cannot be
+   * pinned.
+   */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
@@ -83,6 +83,15 @@ class TablePage : public Page {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Insert a tuple after the last slot, without locking or logging it. For a bulk load into a page that is logged as a
+   * whole once it is full.
+   * @param tuple tuple to insert
+   * @param[out] rid rid of the inserted tuple
+   * @return true if the insert is successful (i.e. there is enough space)
+   */
+  bool AppendTuple(const Tuple &tuple, RID *rid);
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
@@ -106,8 +115,11 @@ class TablePage : public Page {
   bool UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager);
 
-  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
-  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param[out] deleted_tuple the tuple removed from the page, if not null
+   */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple = nullptr);
 
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
@@ -122,6 +134,24 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Compact the page: pack the tuples, deleted or not, against the end of the page, and drop the empty slots at the
+   * end of the slot array. The other slots keep their numbers, so the rids of the tuples stay valid.
+   * @return the number of bytes of free space gained
+   */
+  uint32_t Compact();
+
+  /** @return true if no slot of this page holds a tuple, not even a deleted one that may be rolled back */
+  bool IsEmpty();
+
+  /** @return the number of bytes free for new tuples and their slots */
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return the number of free bytes a page needs to insert the tuple */
+  static uint32_t GetSpaceNeeded(const Tuple &tuple) { return tuple.GetLength() + SIZE_TUPLE; }
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -139,6 +169,8 @@ class TablePage : public Page {
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+  // Offsets and sizes within the page are 32 bits wide, and the top bit of a size is the deleted flag.
+  static_assert(static_cast<uint64_t>(PAGE_SIZE) < DELETE_MASK);
 
   static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
   static constexpr size_t SIZE_TUPLE = 8;
@@ -166,10 +198,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
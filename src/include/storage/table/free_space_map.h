@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap records how much free space each page of a table heap has, so that an insert goes straight to a page
+ * with enough room instead of trying every page of the heap in turn.
+ *
+ * The map is a chain of FreeSpaceMapPages in the buffer pool, with one byte per table page in the order the pages were
+ * added. Like the free space map of PostgreSQL, it is only a hint: the inserter checks the page it is given, and
+ * corrects the map with the actual free space of the page whether or not the tuple fit.
+ *
+ * Latches: a map page is latched while a table page is latched, never the other way around.
+ */
+class FreeSpaceMap {
+ public:
+  /** Where a table page is recorded in the map. */
+  struct Entry {
+    page_id_t map_page_id_{INVALID_PAGE_ID};
+    uint32_t index_{0};
+    page_id_t table_page_id_{INVALID_PAGE_ID};
+  };
+
+  /**
+   * Create an empty map.
+   * @param buffer_pool_manager the buffer pool manager of the table heap
+   */
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Open an existing map.
+   * @param buffer_pool_manager the buffer pool manager of the table heap
+   * @param first_page_id the id of the first page of the map
+   */
+  FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id);
+
+  /**
+   * Find a table page that has room for size bytes, starting where the last search stopped.
+   * @param size the number of bytes needed
+   * @param[out] entry the entry of the table page
+   * @return false if no table page has room
+   */
+  bool FindPage(uint32_t size, Entry *entry);
+
+  /**
+   * Find the entry of a table page.
+   * @param table_page_id the table page
+   * @param[out] entry the entry of the table page
+   * @return false if the table page is not in the map
+   */
+  bool FindEntry(page_id_t table_page_id, Entry *entry);
+
+  /**
+   * Record the free space of a table page.
+   * @param entry the entry of the table page
+   * @param free_space the free space of the table page
+   */
+  void Update(const Entry &entry, uint32_t free_space);
+
+  /**
+   * Add a table page at the end of the map.
+   * @param table_page_id the new table page
+   * @param free_space the free space of the table page
+   * @param[out] entry the entry of the table page, if not null
+   * @return false if a new map page could not be created
+   */
+  bool Add(page_id_t table_page_id, uint32_t free_space, Entry *entry = nullptr);
+
+  /**
+   * Remove the entry of a table page that was removed from the table. The entry is not reused.
+   * @param entry the entry of the table page
+   */
+  void Remove(const Entry &entry);
+
+  /**
+   * List the entries of the map.
+   * @param[out] entries the entries of every table page in the map
+   */
+  void GetEntries(std::vector<Entry> *entries);
+
+  /** @return the id of the first page of the map */
+  page_id_t GetFirstPageId() const { return first_page_id_; }
+
+ private:
+  /** Search the map from an entry to the end for a table page of at least min_category. */
+  bool FindPage(uint32_t min_category, page_id_t start_page_id, uint32_t start_index, Entry *entry);
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  /** Protects everything below. */
+  std::mutex latch_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** Where the next search starts. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  uint32_t next_index_{0};
+};
+
+}  // namespace bustub
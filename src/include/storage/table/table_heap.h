@@ -12,9 +12,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/overflow_page.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -22,7 +31,17 @@ namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages, with a free space map that inserts use to find a page with enough room.
+ *
+ * Concurrent inserters are spread over different pages: each thread keeps inserting into its own target page until it
+ * is full, and a target page is hidden from the free space map of the others meanwhile. A new page is linked after the
+ * last page of the table without a table-wide latch, only the latch of the last page serializes the appends.
+ *
+ * Vacuum compacts the pages and unlinks the empty ones, which it returns to the buffer pool manager for reuse.
+ *
+ * A table heap that knows the schema of its tuples stores the large VARCHAR values of a tuple above OVERFLOW_THRESHOLD
+ * out of line, in chains of overflow pages taken from their own extents. Pages then hold more tuples, and a scan only
+ * reads the overflow pages of the values it accesses.
  */
 class TableHeap {
   friend class TableIterator;
@@ -36,9 +55,13 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param free_space_map_page_id the id of the first page of the free space map, invalid to build the map again from
+   * the pages of the table
+   * @param schema the schema of the tuples, to store large values out of line, or null to keep tuples whole
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, page_id_t free_space_map_page_id = INVALID_PAGE_ID,
+            const Schema *schema = nullptr);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,12 +69,14 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param schema the schema of the tuples, to store large values out of line, or null to keep tuples whole
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, const Schema *schema = nullptr);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table. If the tuple is too large (>= page_size) even with its large values stored out of
+   * line, return false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,6 +84,49 @@ class TableHeap {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
 
+  /**
+   * Load tuples into new pages at the end of the table. The pages are filled in the buffer pool with a page image log
+   * record each, instead of an insert log record, a lock and a write set entry per tuple. So the load cannot be rolled
+   * back by aborting the transaction, it is meant for loading a table its creator has not published yet.
+   * @param first the first tuple to load
+   * @param last the end of the tuples to load
+   * @param txn the transaction performing the load
+   * @param[out] rids the rids of the loaded tuples, if not null
+   * @return false if a tuple is too large or the table could not grow, in which case the transaction is aborted
+   */
+  template <typename InputIterator>
+  bool BulkLoad(InputIterator first, InputIterator last, Transaction *txn, std::vector<RID> *rids = nullptr) {
+    std::shared_lock reclaim_latch(reclaim_latch_);
+    WritePageGuard guard;
+    for (; first != last; ++first) {
+      const Tuple &tuple = *first;
+      RID rid;
+      Tuple small_tuple;
+      const Tuple *stored_tuple = PrepareTuple(tuple, &small_tuple, txn);
+      if (stored_tuple == nullptr) {
+        txn->SetState(TransactionState::ABORTED);
+        return false;
+      }
+      while (!guard.IsValid() || !static_cast<TablePage *>(guard.GetPage())->AppendTuple(*stored_tuple, &rid)) {
+        if (guard.IsValid() && !FinishBulkLoadPage(&guard, txn)) {
+          return AbortInsert(stored_tuple, small_tuple, txn);
+        }
+        guard = AppendPage(txn);
+        if (!guard.IsValid()) {
+          return AbortInsert(stored_tuple, small_tuple, txn);
+        }
+      }
+      if (rids != nullptr) {
+        rids->push_back(rid);
+      }
+    }
+    if (guard.IsValid() && !FinishBulkLoadPage(&guard, txn)) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    return true;
+  }
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -69,6 +137,8 @@ class TableHeap {
 
   /**
    * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * The same goes for a tuple with values stored out of line, before or after the update, so that the overflow pages of
+   * the old version are freed when the delete is applied.
    * @param tuple new tuple
    * @param rid rid of the old tuple
    * @param txn transaction performing the update
@@ -99,6 +169,26 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Compact every page of the table, record its free space in the free space map, and reclaim the pages left empty:
+   * they are unlinked from the table and deallocated. Runs alongside inserts, deletes and updates. The first and the
+   * last page are kept, and no page is reclaimed while an iterator over the table is open. Tuples marked deleted stay
+   * until their transaction applies or rolls back the delete.
+   * @param txn the transaction performing the vacuum
+   * @return the number of bytes reclaimed, the free space gained by compaction plus the size of the reclaimed pages
+   */
+  size_t Vacuum(Transaction *txn);
+
+  /**
+   * Read a value stored out of line, called by a tuple read from this table when the value is accessed.
+   * @param type the type of the value
+   * @param first_page_id the first overflow page of the value
+   * @param length the length of the value
+   * @param[out] value the value
+   * @return false if an overflow page could not be fetched
+   */
+  bool ReadOverflowValue(TypeId type, page_id_t first_page_id, uint32_t length, Value *value);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -108,11 +198,125 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the id of the first page of the free space map of this table, to open the table with */
+  inline page_id_t GetFreeSpaceMapPageId() const { return free_space_map_->GetFirstPageId(); }
+
  private:
+  /** The page a thread inserts into, shared by the threads assigned to the same target. */
+  struct InsertTarget {
+    std::mutex latch_;
+    /** The entry of the page in the free space map, with an invalid page id if there is no target page. */
+    FreeSpaceMap::Entry entry_;
+  };
+
+  /** @return the insert target of the calling thread */
+  InsertTarget *GetInsertTarget();
+
+  /**
+   * Make a page the target of the inserts of a thread, unless another thread has set a target meanwhile. The page is
+   * hidden from the free space map while it is a target.
+   * @param target the insert target
+   * @param entry the entry of the page in the free space map
+   * @param free_space the free space of the page, recorded in the free space map if the page is not made the target
+   */
+  void SetInsertTarget(InsertTarget *target, const FreeSpaceMap::Entry &entry, uint32_t free_space);
+
+  /** Insert a tuple into a new page at the end of the table. */
+  bool AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn, FreeSpaceMap::Entry *entry);
+
+  /**
+   * Link a new page after the last page of the table.
+   * @return a guard that holds the new page write latched, or no page if the table could not grow
+   */
+  WritePageGuard AppendPage(Transaction *txn);
+
+  /**
+   * Log the image of a page filled by a bulk load and release it to the free space map and the other threads.
+   * @return false if the page could not be added to the free space map
+   */
+  bool FinishBulkLoadPage(WritePageGuard *guard, Transaction *txn);
+
+  /**
+   * Store the largest values of a tuple above OVERFLOW_THRESHOLD out of line until it is below the threshold.
+   * @param tuple the tuple to insert
+   * @param[out] small_tuple the tuple with its large values stored out of line, if any
+   * @param txn the transaction performing the insert
+   * @return the tuple to store in a table page, either tuple or small_tuple, or null if it is too large for a page
+   */
+  const Tuple *PrepareTuple(const Tuple &tuple, Tuple *small_tuple, Transaction *txn);
+
+  /**
+   * Give up on inserting a tuple: deallocate the values PrepareTuple stored out of line and abort the transaction.
+   * @param stored_tuple the tuple PrepareTuple returned
+   * @param small_tuple the tuple PrepareTuple filled in
+   * @param txn the transaction performing the insert
+   * @return false, for the insert to return
+   */
+  bool AbortInsert(const Tuple *stored_tuple, const Tuple &small_tuple, Transaction *txn);
+
+  /**
+   * Write a value into a new chain of overflow pages.
+   * @return the id of the first page of the chain, INVALID_PAGE_ID if the pages could not be created
+   */
+  page_id_t WriteOverflowValue(const char *data, uint32_t size, Transaction *txn);
+
+  /** Deallocate a chain of overflow pages. */
+  void DeleteOverflowValue(page_id_t first_page_id);
+
+  /** Deallocate the chains of overflow pages of the values of a tuple stored out of line. */
+  void DeleteOverflowValues(const Tuple &tuple);
+
+  /** @return true if some values of the tuple are stored out of line */
+  bool HasOverflowValues(const Tuple &tuple);
+
+  /** Log the whole contents of a page, if logging is enabled. */
+  void LogPageImage(WritePageGuard *guard, Transaction *txn);
+
+  /**
+   * Unlink an empty page from the table and deallocate it, unless it is no longer empty, is the last page, or an
+   * iterator is open.
+   * @param prev_page_id the page before the empty page
+   * @param page_id the empty page
+   * @param entries the entries of the free space map, by table page
+   * @param txn the transaction performing the vacuum
+   * @return true if the page was reclaimed
+   */
+  bool ReclaimPage(page_id_t prev_page_id, page_id_t page_id,
+                   const std::unordered_map<page_id_t, FreeSpaceMap::Entry> &entries, Transaction *txn);
+
+  /** @return true if the page is the target of an inserting thread */
+  bool IsInsertTarget(page_id_t page_id);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** The schema of the tuples, null if the values are never stored out of line. */
+  const Schema *schema_;
+  /** New pages of the table are taken from runs of contiguous pages, so that a scan reads the file sequentially. */
+  Extent extent_;
+  /** Overflow pages come from extents of their own, so that they do not break up the runs of table pages. */
+  Extent overflow_extent_;
+  /** Tuples larger than this have their largest values stored out of line, like in TOAST. */
+  static constexpr uint32_t OVERFLOW_THRESHOLD = PAGE_SIZE / 4;
+  std::unique_ptr<FreeSpaceMap> free_space_map_;
+  /** At least this many insert targets, so that threads are spread over pages even on few cores. */
+  static constexpr unsigned MIN_INSERT_TARGETS = 16;
+
+  /** One insert target per core, the threads are assigned to them in turn. */
+  std::vector<InsertTarget> insert_targets_;
+  /**
+   * A page at or near the end of the table, where an append starts looking for the last page. Invalid until the first
+   * append if the table was opened with its free space map.
+   */
+  std::atomic<page_id_t> last_page_id_{INVALID_PAGE_ID};
+  /**
+   * Held shared by inserts, which may be about to latch a page they found in the free space map, and exclusive while
+   * a page is reclaimed.
+   */
+  std::shared_mutex reclaim_latch_;
+  /** Number of iterators over this table, which may be positioned on a page between calls. */
+  std::atomic<size_t> num_iterators_{0};
 };
 
 }  // namespace bustub
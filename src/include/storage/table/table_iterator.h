@@ -13,7 +13,9 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
+#include "buffer/buffer_ring.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -24,17 +26,24 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ * The table heap counts its open iterators, so that vacuum does not reclaim a page an iterator is positioned on.
  */
 class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * Create an iterator positioned at a tuple.
+   * @param table_heap the table heap to iterate over
+   * @param rid the tuple to start at, INVALID_PAGE_ID for the end iterator
+   * @param txn the transaction doing the scan
+   * @param ring the buffer ring pages are read through, nullptr to fetch them like any other caller
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, std::shared_ptr<BufferRing> ring = nullptr);
 
-  TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+  TableIterator(const TableIterator &other);
 
-  ~TableIterator() { delete tuple_; }
+  ~TableIterator();
 
   inline bool operator==(const TableIterator &itr) const { return tuple_->rid_.Get() == itr.tuple_->rid_.Get(); }
 
@@ -48,17 +57,14 @@ class TableIterator {
 
   TableIterator operator++(int);
 
-  TableIterator &operator=(const TableIterator &other) {
-    table_heap_ = other.table_heap_;
-    *tuple_ = *other.tuple_;
-    txn_ = other.txn_;
-    return *this;
-  }
+  TableIterator &operator=(const TableIterator &other);
 
  private:
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** Buffer ring of the scan, shared by copies of the iterator. */
+  std::shared_ptr<BufferRing> ring_;
 };
 
 }  // namespace bustub
@@ -21,11 +21,17 @@
 
 namespace bustub {
 
+class TableHeap;
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
  * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
  * ---------------------------------------------------------------------
+ *
+ * The payload of a varied-sized field is its length followed by its data. A table heap may move a large value out of
+ * line, into overflow pages: the payload is then its length with the OVERFLOW_FLAG bit set, followed by the id of the
+ * first overflow page. The value is read from the overflow pages when the column is accessed.
  */
 class Tuple {
   friend class TablePage;
@@ -74,6 +80,7 @@ class Tuple {
 
   // Get the value of a specified column (const)
   // checks the schema to see how to return the Value.
+  // Throws an OUT_OF_MEMORY Exception if a value stored out of line cannot be read into the buffer pool.
   Value GetValue(const Schema *schema, uint32_t column_idx) const;
 
   // Generates a key tuple given schemas and attributes
@@ -89,13 +96,38 @@ class Tuple {
   std::string ToString(const Schema *schema) const;
 
  private:
+  /** Set in the length of a varied-sized value stored out of line. */
+  static constexpr uint32_t OVERFLOW_FLAG = 1U << 31;
+  /** Size of the payload of a value stored out of line: its length and the id of its first overflow page. */
+  static constexpr uint32_t OVERFLOW_PAYLOAD_SIZE = sizeof(uint32_t) + sizeof(page_id_t);
+
   // Get the starting storage address of specific column
   const char *GetDataPtr(const Schema *schema, uint32_t column_idx) const;
 
+  /**
+   * Get the first overflow page of a varied-sized value.
+   * @return the id of the first overflow page, INVALID_PAGE_ID if the value is stored in the tuple
+   */
+  page_id_t GetOverflowPageId(const Schema *schema, uint32_t column_idx) const;
+
+  // Get the size of the payload of a varied-sized value, including its length
+  uint32_t GetPayloadSize(const Schema *schema, uint32_t column_idx) const;
+
+  /**
+   * Copy this tuple with some of its varied-sized values stored out of line.
+   * @param schema the schema of the tuple
+   * @param overflow_page_ids for each column, the id of the first overflow page its value was written to, or
+   * INVALID_PAGE_ID to keep the value in the tuple
+   * @return the copy
+   */
+  Tuple MoveOutOfLine(const Schema *schema, const std::vector<page_id_t> &overflow_page_ids) const;
+
   bool allocated_{false};  // is allocated?
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
   char *data_{nullptr};
+  /** The table heap the tuple was read from, which holds the values stored out of line. */
+  TableHeap *table_heap_{nullptr};
 };
 
 }  // namespace bustub
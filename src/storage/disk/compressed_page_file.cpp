@@ -0,0 +1,263 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_file.cpp
+//
+// Identification: src/storage/disk/compressed_page_file.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/compressed_page_file.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/util/compression_util.h"
+
+namespace bustub {
+
+namespace {
+
+/** Read a byte range of a file, retrying short reads; returns false if the file ends first. */
+bool ReadFully(int fd, char *data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t count = pread(fd, data, size, offset);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    data += count;
+    size -= count;
+    offset += count;
+  }
+  return true;
+}
+
+/** Write a byte range of a file, retrying short writes. */
+bool WriteFully(int fd, const char *data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t count = pwrite(fd, data, size, offset);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    data += count;
+    size -= count;
+    offset += count;
+  }
+  return true;
+}
+
+}  // namespace
+
+CompressedPageFile::CompressedPageFile(int fd, std::string map_file_name, bool reset)
+    : fd_(fd), free_slots_(SLOTS_PER_PAGE + 1) {
+  if (reset) {
+    remove(map_file_name.c_str());
+  }
+  map_io_.open(map_file_name, std::ios::binary | std::ios::in | std::ios::out);
+  if (!map_io_.is_open()) {
+    map_io_.clear();
+    map_io_.open(map_file_name, std::ios::binary | std::ios::trunc | std::ios::in | std::ios::out);
+    if (!map_io_.is_open()) {
+      throw Exception("can't open slot map file");
+    }
+    return;
+  }
+  map_io_.seekg(0, std::ios::end);
+  size_t file_size = map_io_.tellg();
+  slot_map_.resize(file_size / sizeof(SlotRun), SlotRun{0, 0});
+  map_io_.seekg(0);
+  map_io_.read(reinterpret_cast<char *>(slot_map_.data()), slot_map_.size() * sizeof(SlotRun));
+  if (map_io_.bad()) {
+    throw Exception("can't read slot map file");
+  }
+  map_io_.clear();
+
+  // Every slot that no page maps to is free.
+  std::vector<std::pair<uint32_t, size_t>> used;
+  for (const auto &run : slot_map_) {
+    if (run.size_ != 0) {
+      used.emplace_back(run.first_slot_, run.GetNumSlots());
+    }
+  }
+  std::sort(used.begin(), used.end());
+  for (auto [first_slot, num_slots] : used) {
+    if (first_slot > end_slot_) {
+      FreeSlots(end_slot_, first_slot - end_slot_);
+    }
+    end_slot_ = std::max<uint32_t>(end_slot_, first_slot + num_slots);
+  }
+}
+
+bool CompressedPageFile::WritePage(page_id_t page_id, const char *data) {
+  // The data is padded to whole slots, so that the last run of the file can be read whole.
+  std::vector<char> stored(PAGE_SIZE, 0);
+  size_t size = CompressionUtil::Compress(data, PAGE_SIZE, stored.data(), PAGE_SIZE - SLOT_SIZE);
+  if (size == 0) {
+    memcpy(stored.data(), data, PAGE_SIZE);
+    size = PAGE_SIZE;
+  }
+  SlotRun run{0, static_cast<uint32_t>(size)};
+  SlotRun old_run{0, 0};
+  bool in_place;
+  {
+    std::scoped_lock lock{latch_};
+    if (static_cast<size_t>(page_id) >= slot_map_.size()) {
+      slot_map_.resize(page_id + 1, SlotRun{0, 0});
+    }
+    old_run = slot_map_[page_id];
+    in_place = old_run.GetNumSlots() >= run.GetNumSlots();
+    run.first_slot_ = in_place ? old_run.first_slot_ : AllocateSlots(run.GetNumSlots());
+  }
+  if (!WriteFully(fd_, stored.data(), run.GetNumSlots() * SLOT_SIZE,
+                  static_cast<off_t>(run.first_slot_) * SLOT_SIZE)) {
+    LOG_DEBUG("I/O error while writing a compressed page");
+    return false;
+  }
+  std::scoped_lock lock{latch_};
+  slot_map_[page_id] = run;
+  WriteSlotRun(page_id);
+  if (in_place) {
+    // The page stayed in its run, the slots it no longer needs are free.
+    FreeSlots(run.first_slot_ + run.GetNumSlots(), old_run.GetNumSlots() - run.GetNumSlots());
+  } else {
+    FreeSlots(old_run.first_slot_, old_run.GetNumSlots());
+  }
+  return true;
+}
+
+bool CompressedPageFile::ReadPage(page_id_t page_id, char *data) { return ReadPages(page_id, {data}); }
+
+bool CompressedPageFile::ReadPages(page_id_t page_id, const std::vector<char *> &data) {
+  std::vector<SlotRun> runs(data.size(), SlotRun{0, 0});
+  {
+    std::scoped_lock lock{latch_};
+    for (size_t i = 0; i < data.size() && page_id + i < slot_map_.size(); i++) {
+      runs[i] = slot_map_[page_id + i];
+    }
+  }
+  uint32_t first_slot = std::numeric_limits<uint32_t>::max();
+  uint32_t end_slot = 0;
+  size_t num_slots = 0;
+  for (size_t i = 0; i < data.size(); i++) {
+    if (runs[i].size_ == 0) {
+      memset(data[i], 0, PAGE_SIZE);
+      continue;
+    }
+    first_slot = std::min(first_slot, runs[i].first_slot_);
+    end_slot = std::max<uint32_t>(end_slot, runs[i].first_slot_ + runs[i].GetNumSlots());
+    num_slots += runs[i].GetNumSlots();
+  }
+  if (num_slots == 0) {
+    return true;
+  }
+
+  bool success = true;
+  // The slots are read with a single read unless they are scattered over the file, e.g. after many rewrites.
+  if (end_slot - first_slot <= 2 * num_slots) {
+    std::vector<char> stored((end_slot - first_slot) * SLOT_SIZE);
+    if (!ReadFully(fd_, stored.data(), stored.size(), static_cast<off_t>(first_slot) * SLOT_SIZE)) {
+      LOG_DEBUG("I/O error while reading compressed pages");
+      return false;
+    }
+    for (size_t i = 0; i < data.size(); i++) {
+      if (runs[i].size_ != 0) {
+        success = DecodePage(runs[i], stored.data() + (runs[i].first_slot_ - first_slot) * SLOT_SIZE, data[i]) &&
+                  success;
+      }
+    }
+    return success;
+  }
+  std::vector<char> stored(PAGE_SIZE);
+  for (size_t i = 0; i < data.size(); i++) {
+    if (runs[i].size_ == 0) {
+      continue;
+    }
+    if (!ReadFully(fd_, stored.data(), runs[i].GetNumSlots() * SLOT_SIZE,
+                   static_cast<off_t>(runs[i].first_slot_) * SLOT_SIZE)) {
+      LOG_DEBUG("I/O error while reading a compressed page");
+      return false;
+    }
+    success = DecodePage(runs[i], stored.data(), data[i]) && success;
+  }
+  return success;
+}
+
+page_id_t CompressedPageFile::GetNumPages() {
+  std::scoped_lock lock{latch_};
+  return static_cast<page_id_t>(slot_map_.size());
+}
+
+size_t CompressedPageFile::GetNumSlots() {
+  std::scoped_lock lock{latch_};
+  return end_slot_;
+}
+
+void CompressedPageFile::Close() {
+  std::scoped_lock lock{latch_};
+  map_io_.close();
+}
+
+uint32_t CompressedPageFile::AllocateSlots(size_t num_slots) {
+  for (size_t size = num_slots; size <= SLOTS_PER_PAGE; size++) {
+    if (free_slots_[size].empty()) {
+      continue;
+    }
+    uint32_t first_slot = free_slots_[size].back();
+    free_slots_[size].pop_back();
+    FreeSlots(first_slot + num_slots, size - num_slots);
+    return first_slot;
+  }
+  uint32_t first_slot = end_slot_;
+  end_slot_ += num_slots;
+  return first_slot;
+}
+
+void CompressedPageFile::FreeSlots(uint32_t first_slot, size_t num_slots) {
+  for (; num_slots > 0; num_slots -= std::min(num_slots, SLOTS_PER_PAGE)) {
+    free_slots_[std::min(num_slots, SLOTS_PER_PAGE)].push_back(first_slot);
+    first_slot += SLOTS_PER_PAGE;
+  }
+}
+
+bool CompressedPageFile::DecodePage(const SlotRun &run, const char *stored, char *data) {
+  if (run.size_ == PAGE_SIZE) {
+    memcpy(data, stored, PAGE_SIZE);
+    return true;
+  }
+  if (!CompressionUtil::Decompress(stored, run.size_, data, PAGE_SIZE)) {
+    LOG_DEBUG("compressed page does not decompress");
+    return false;
+  }
+  return true;
+}
+
+void CompressedPageFile::WriteSlotRun(page_id_t page_id) {
+  if (!map_io_.is_open()) {
+    return;
+  }
+  map_io_.seekp(static_cast<size_t>(page_id) * sizeof(SlotRun));
+  map_io_.write(reinterpret_cast<const char *>(&slot_map_[page_id]), sizeof(SlotRun));
+  if (map_io_.bad()) {
+    LOG_DEBUG("I/O error while writing the slot map");
+    return;
+  }
+  map_io_.flush();
+}
+
+}  // namespace bustub
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_backend.cpp
+//
+// Identification: src/storage/disk/disk_backend.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_backend.h"
+
+namespace bustub {
+
+bool DiskBackend::WritePages(const std::vector<std::pair<page_id_t, char *>> &pages) {
+  std::vector<std::future<bool>> writes;
+  for (auto [page_id, data] : pages) {
+    DiskRequest request{true, page_id, data, {}};
+    writes.push_back(request.callback_.get_future());
+    Schedule(std::move(request));
+  }
+  bool success = true;
+  for (auto &write : writes) {
+    success = write.get() && success;
+  }
+  return success;
+}
+
+}  // namespace bustub
@@ -10,16 +10,28 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cstring>
+#include <future>  // NOLINT
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/io_uring_disk_backend.h"
+#include "storage/disk/posix_disk_backend.h"
 
 namespace bustub {
 
@@ -29,14 +41,34 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
-  std::string::size_type n = file_name_.rfind('.');
+DiskManager::DiskManager(const std::string &db_file, DiskBackendType backend_type)
+    : DiskManager(std::vector<std::string>{db_file}, 0, backend_type) {}
+
+/**
+ * Constructor: open/create the data files of a tablespace & log file
+ * @input data_files: data file names, the first one names the log file
+ */
+DiskManager::DiskManager(const std::vector<std::string> &data_files, page_id_t max_pages_per_file,
+                         DiskBackendType backend_type, bool compress_pages)
+    : backend_type_(backend_type),
+      compress_pages_(compress_pages),
+      num_flushes_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
+  BUSTUB_ASSERT(!data_files.empty(), "A tablespace needs at least one data file.");
+  for (const auto &name : data_files) {
+    data_files_.emplace_back(std::make_unique<DataFile>());
+    data_files_.back()->name_ = name;
+  }
+  const std::string &db_file = data_files[0];
+  std::string::size_type n = db_file.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
+    free_pages_ = std::make_unique<FreePageBitmap>("", 0, false);
+    checksums_ = std::make_unique<PageChecksums>("", false);
     return;
   }
-  log_name_ = file_name_.substr(0, n) + ".log";
+  log_name_ = db_file.substr(0, n) + ".log";
 
   log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
   // directory or file does not exist
@@ -52,74 +84,599 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  bool created = false;
+  page_id_t num_pages = 0;
+  for (size_t i = 0; i < data_files_.size(); i++) {
+    created = OpenDataFile(data_files_[i].get()) || created;
+    // Every page below the last page of a file counts as allocated if there is no bitmap file.
+    const auto &compressed = data_files_[i]->compressed_;
+    page_id_t file_num_pages =
+        compressed != nullptr ? compressed->GetNumPages()
+                              : static_cast<page_id_t>(GetFileSize(data_files_[i]->name_) / PAGE_SIZE);
+    if (file_num_pages > 0) {
+      num_pages = std::max(num_pages, GetPageId(i, file_num_pages - 1) + 1);
     }
   }
   buffer_used = nullptr;
+
+  page_id_t capacity = std::numeric_limits<page_id_t>::max();
+  if (max_pages_per_file > 0) {
+    capacity = max_pages_per_file / EXTENT_SIZE * EXTENT_SIZE * static_cast<page_id_t>(data_files_.size());
+  }
+  // A bitmap left over from an earlier database file of the same name is stale.
+  free_pages_ = std::make_unique<FreePageBitmap>(db_file.substr(0, n) + ".fsm", num_pages, created, capacity);
+  checksums_ = std::make_unique<PageChecksums>(db_file.substr(0, n) + ".crc", created);
+}
+
+/**
+ * Wait for the backends to complete their requests, and close their files
+ */
+DiskManager::~DiskManager() {
+  StopScrubber();
+  for (auto &file : data_files_) {
+    UnmapDataFile(file.get());
+    file->backend_.reset();
+    file->compressed_.reset();
+    if (file->fd_ >= 0) {
+      close(file->fd_);
+    }
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
+  StopScrubber();
+  for (auto &file : data_files_) {
+    CloseDataFile(file.get());
+  }
   log_io_.close();
+  free_pages_->Close();
+  checksums_->Close();
+}
+
+/**
+ * Private helper function to open a data file, and set up its backend
+ */
+bool DiskManager::OpenDataFile(DataFile *file) {
+  const std::string &name = file->name_;
+  file->io_.open(name, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  bool created = !file->io_.is_open();
+  if (created) {
+    file->io_.clear();
+    // create a new file
+    file->io_.open(name, std::ios::binary | std::ios::trunc | std::ios::out);
+    file->io_.close();
+    // reopen with original mode
+    file->io_.open(name, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file->io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+
+  if (compress_pages_) {
+    // The slots of compressed pages are smaller than the blocks of direct I/O, they are read through the page cache.
+    file->fd_ = open(name.c_str(), O_RDWR);
+    if (file->fd_ < 0) {
+      throw Exception("can't open db file");
+    }
+    std::string::size_type n = name.rfind('.');
+    file->compressed_ = std::make_unique<CompressedPageFile>(file->fd_, name.substr(0, n) + ".map", created);
+  } else if (backend_type_ == DiskBackendType::IO_URING) {
+    file->fd_ = open(name.c_str(), O_RDWR);
+    if (file->fd_ < 0) {
+      throw Exception("can't open db file");
+    }
+    try {
+      file->backend_ = std::make_unique<IoUringDiskBackend>(file->fd_);
+    } catch (const Exception &e) {
+      LOG_WARN("io_uring is not available, falling back to the file stream");
+      close(file->fd_);
+      file->fd_ = -1;
+    }
+  } else if (backend_type_ == DiskBackendType::POSIX) {
+    // Bypass the page cache, the buffer pool already caches the pages. Some file systems (e.g. tmpfs) do not support
+    // direct I/O, in which case the file is read and written through the page cache.
+    file->fd_ = open(name.c_str(), O_RDWR | O_DIRECT);
+    if (file->fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("direct I/O is not supported for the db file, using the page cache");
+      file->fd_ = open(name.c_str(), O_RDWR);
+    }
+    if (file->fd_ < 0) {
+      throw Exception("can't open db file");
+    }
+    file->backend_ = std::make_unique<PosixDiskBackend>(file->fd_);
+  }
+  return created;
+}
+
+/**
+ * Private helper function to close a data file
+ */
+void DiskManager::CloseDataFile(DataFile *file) {
+  UnmapDataFile(file);
+  file->backend_.reset();
+  if (file->compressed_ != nullptr) {
+    file->compressed_->Close();
+    file->compressed_.reset();
+  }
+  if (file->fd_ >= 0) {
+    close(file->fd_);
+    file->fd_ = -1;
+  }
+  std::scoped_lock io_lock(file->io_latch_);
+  file->io_.close();
+}
+
+/**
+ * Map every data file read-only, as far as it reaches now
+ */
+bool DiskManager::MapDataFiles() {
+  if (compress_pages_) {
+    LOG_WARN("compressed data files cannot be mapped");
+    return false;
+  }
+  for (auto &file : data_files_) {
+    if (file->map_data_ != nullptr) {
+      continue;
+    }
+    off_t file_size = GetFileSize(file->name_);
+    if (file_size < PAGE_SIZE) {
+      continue;
+    }
+    auto size = static_cast<size_t>(file_size / PAGE_SIZE * PAGE_SIZE);
+    // The mapping keeps the file open on its own.
+    int fd = open(file->name_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+      LOG_WARN("can't map data file %s", file->name_.c_str());
+      return false;
+    }
+    file->map_data_ = static_cast<char *>(map);
+    file->map_size_ = size;
+  }
+  mapped_ = true;
+  return true;
+}
+
+/**
+ * Private helper function to unmap a data file
+ */
+void DiskManager::UnmapDataFile(DataFile *file) {
+  if (file->map_data_ != nullptr) {
+    munmap(file->map_data_, file->map_size_);
+    file->map_data_ = nullptr;
+    file->map_size_ = 0;
+  }
+}
+
+/**
+ * Read a page from the memory mapping of its data file, without a copy
+ */
+const char *DiskManager::ReadMappedPage(page_id_t page_id) {
+  page_id_t file_page_id;
+  DataFile *file = data_files_[LocatePage(page_id, &file_page_id)].get();
+  size_t offset = static_cast<size_t>(file_page_id) * PAGE_SIZE;
+  if (file->map_data_ == nullptr || offset >= file->map_size_) {
+    return nullptr;
+  }
+  file->num_reads_ += 1;
+  VerifyPage(page_id, file->map_data_ + offset);
+  return file->map_data_ + offset;
+}
+
+/**
+ * Private helper function to find the data file of a page: stripe i of EXTENT_SIZE pages is the
+ * (i / number of files)-th stripe of file (i % number of files)
+ */
+size_t DiskManager::LocatePage(page_id_t page_id, page_id_t *file_page_id) const {
+  auto num_files = static_cast<page_id_t>(data_files_.size());
+  page_id_t stripe = page_id / EXTENT_SIZE;
+  *file_page_id = stripe / num_files * EXTENT_SIZE + page_id % EXTENT_SIZE;
+  return stripe % num_files;
+}
+
+/**
+ * Private helper function to find the page at a position within a data file
+ */
+page_id_t DiskManager::GetPageId(size_t file_index, page_id_t file_page_id) const {
+  auto num_files = static_cast<page_id_t>(data_files_.size());
+  page_id_t stripe = file_page_id / EXTENT_SIZE * num_files + static_cast<page_id_t>(file_index);
+  return stripe * EXTENT_SIZE + file_page_id % EXTENT_SIZE;
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  page_id_t file_page_id;
+  DataFile *file = data_files_[LocatePage(page_id, &file_page_id)].get();
+  if (file->backend_ != nullptr) {
+    WritePageAsync(page_id, page_data).get();
+    return;
+  }
+  checksums_->Update(page_id, page_data);
+  if (file->compressed_ != nullptr) {
+    file->num_writes_ += 1;
+    file->compressed_->WritePage(file_page_id, page_data);
+    return;
+  }
+  std::scoped_lock io_lock(file->io_latch_);
+  size_t offset = static_cast<size_t>(file_page_id) * PAGE_SIZE;
   // set write cursor to offset
-  num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  file->num_writes_ += 1;
+  file->io_.seekp(offset);
+  file->io_.write(page_data, PAGE_SIZE);
   // check for I/O error
-  if (db_io_.bad()) {
+  if (file->io_.bad()) {
     LOG_DEBUG("I/O error while writing");
     return;
   }
   // needs to flush to keep disk file in sync
-  db_io_.flush();
+  file->io_.flush();
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
+  page_id_t file_page_id;
+  DataFile *file = data_files_[LocatePage(page_id, &file_page_id)].get();
+  if (file->backend_ != nullptr) {
+    ReadPageAsync(page_id, page_data).get();
+    return;
+  }
+  ReadPageFromStream(page_id, page_data);
+}
+
+/**
+ * Private helper function to read a page through the stream, or the compressed pages, of its data file, and verify it
+ */
+bool DiskManager::ReadPageFromStream(page_id_t page_id, char *page_data) {
+  page_id_t file_page_id;
+  DataFile *file = data_files_[LocatePage(page_id, &file_page_id)].get();
+  if (file->compressed_ != nullptr) {
+    file->num_reads_ += 1;
+    return file->compressed_->ReadPage(file_page_id, page_data) && VerifyPage(page_id, page_data);
+  }
+  {
+    std::scoped_lock io_lock(file->io_latch_);
+    file->num_reads_ += 1;
+    off_t offset = static_cast<off_t>(file_page_id) * PAGE_SIZE;
+    // check if read beyond file length
+    if (offset > GetFileSize(file->name_)) {
+      LOG_DEBUG("I/O error reading past end of file");
+      // std::cerr << "I/O error while reading" << std::endl;
+      return true;
+    }
     // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
+    file->io_.seekp(offset);
+    file->io_.read(page_data, PAGE_SIZE);
+    if (file->io_.bad()) {
       LOG_DEBUG("I/O error while reading");
-      return;
+      return false;
     }
     // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
+    int read_count = file->io_.gcount();
     if (read_count < PAGE_SIZE) {
       LOG_DEBUG("Read less than a page");
-      db_io_.clear();
+      file->io_.clear();
       // std::cerr << "Read less than a page" << std::endl;
       memset(page_data + read_count, 0, PAGE_SIZE - read_count);
     }
   }
+  return VerifyPage(page_id, page_data);
+}
+
+/**
+ * Read the contents of consecutive pages, starting at the specified page, into the given memory areas
+ */
+void DiskManager::ReadPages(page_id_t page_id, const std::vector<char *> &page_data) {
+  if (data_files_[0]->backend_ != nullptr) {
+    // The backend reads the pages straight into their buffers, concurrently if it can have many requests in flight.
+    std::vector<std::future<bool>> reads;
+    for (size_t i = 0; i < page_data.size(); i++) {
+      reads.push_back(ReadPageAsync(page_id + static_cast<page_id_t>(i), page_data[i]));
+    }
+    for (auto &read : reads) {
+      read.get();
+    }
+    return;
+  }
+  // The pages of a stripe are consecutive in their file, each stripe is read with one seek and read.
+  for (size_t start = 0; start < page_data.size();) {
+    page_id_t file_page_id;
+    DataFile *file = data_files_[LocatePage(page_id + static_cast<page_id_t>(start), &file_page_id)].get();
+    size_t end = std::min(page_data.size(), start + EXTENT_SIZE - file_page_id % EXTENT_SIZE);
+    if (file->compressed_ != nullptr) {
+      file->num_reads_ += end - start;
+      std::vector<char *> stripe_data(page_data.begin() + start, page_data.begin() + end);
+      if (file->compressed_->ReadPages(file_page_id, stripe_data)) {
+        for (size_t i = start; i < end; i++) {
+          VerifyPage(page_id + static_cast<page_id_t>(i), page_data[i]);
+        }
+      }
+      start = end;
+      continue;
+    }
+    // Pages past the end of the file read as zeros, like in ReadPage.
+    std::vector<char> buffer((end - start) * PAGE_SIZE, 0);
+    {
+      std::scoped_lock io_lock(file->io_latch_);
+      file->num_reads_ += end - start;
+      off_t offset = static_cast<off_t>(file_page_id) * PAGE_SIZE;
+      if (offset > GetFileSize(file->name_)) {
+        LOG_DEBUG("I/O error reading past end of file");
+      } else {
+        file->io_.seekp(offset);
+        file->io_.read(buffer.data(), buffer.size());
+        if (file->io_.bad()) {
+          LOG_DEBUG("I/O error while reading");
+          return;
+        }
+        if (static_cast<size_t>(file->io_.gcount()) < buffer.size()) {
+          file->io_.clear();
+        }
+      }
+    }
+    for (size_t i = start; i < end; i++) {
+      memcpy(page_data[i], buffer.data() + (i - start) * PAGE_SIZE, PAGE_SIZE);
+      VerifyPage(page_id + static_cast<page_id_t>(i), page_data[i]);
+    }
+    start = end;
+  }
+}
+
+/**
+ * Write the contents of a batch of pages into disk file, coalescing runs of consecutive pages, then sync every file
+ * that was written once
+ */
+void DiskManager::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  // Split the batch by data file. The pages of a file stay sorted, and consecutive pages of a stripe stay consecutive.
+  std::sort(pages.begin(), pages.end());
+  checksums_->Update(pages);
+  // The checksums are written before the pages, and synced before them too, so that a synced page never has an older
+  // checksum after a crash.
+  checksums_->Sync();
+  // A page allocated in the bitmap file has to be durable there before its data is, or a crash could hand it out again.
+  free_pages_->Sync();
+  std::vector<std::vector<std::pair<page_id_t, char *>>> file_pages(data_files_.size());
+  for (auto [page_id, page_data] : pages) {
+    page_id_t file_page_id;
+    size_t file_index = LocatePage(page_id, &file_page_id);
+    // The write only reads the data.
+    file_pages[file_index].emplace_back(file_page_id, const_cast<char *>(page_data));
+    data_files_[file_index]->num_writes_ += 1;
+  }
+  for (size_t i = 0; i < data_files_.size(); i++) {
+    DataFile *file = data_files_[i].get();
+    const auto &writes = file_pages[i];
+    if (writes.empty()) {
+      continue;
+    }
+    if (file->compressed_ != nullptr) {
+      for (auto [file_page_id, page_data] : writes) {
+        file->compressed_->WritePage(file_page_id, page_data);
+      }
+    } else if (file->backend_ != nullptr) {
+      if (!file->backend_->WritePages(writes)) {
+        LOG_DEBUG("I/O error while writing pages");
+      }
+    } else {
+      std::scoped_lock io_lock(file->io_latch_);
+      for (size_t j = 0; j < writes.size(); j++) {
+        // The stream is already positioned after the previous page of a run.
+        if (j == 0 || writes[j].first != writes[j - 1].first + 1) {
+          file->io_.seekp(static_cast<size_t>(writes[j].first) * PAGE_SIZE);
+        }
+        file->io_.write(writes[j].second, PAGE_SIZE);
+      }
+      if (file->io_.bad()) {
+        LOG_DEBUG("I/O error while writing");
+        continue;
+      }
+      file->io_.flush();
+    }
+    SyncFile(file);
+  }
+}
+
+/**
+ * Start writing the contents of the specified page into disk file, the stream writes it right away
+ */
+std::future<bool> DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) {
+  page_id_t file_page_id;
+  DataFile *file = data_files_[LocatePage(page_id, &file_page_id)].get();
+  if (file->backend_ == nullptr) {
+    std::promise<bool> done;
+    WritePage(page_id, page_data);
+    done.set_value(true);
+    return done.get_future();
+  }
+  file->num_writes_ += 1;
+  checksums_->Update(page_id, page_data);
+  // The backend only reads the data of a write.
+  DiskRequest request{true, file_page_id, const_cast<char *>(page_data), {}};
+  auto future = request.callback_.get_future();
+  file->backend_->Schedule(std::move(request));
+  return future;
+}
+
+/**
+ * Start reading the contents of the specified page into the given memory area, the stream reads it right away
+ */
+std::future<bool> DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) {
+  page_id_t file_page_id;
+  DataFile *file = data_files_[LocatePage(page_id, &file_page_id)].get();
+  if (file->backend_ == nullptr) {
+    std::promise<bool> done;
+    done.set_value(ReadPageFromStream(page_id, page_data));
+    return done.get_future();
+  }
+  file->num_reads_ += 1;
+  DiskRequest request{false, file_page_id, page_data, {}};
+  auto read = request.callback_.get_future();
+  file->backend_->Schedule(std::move(request));
+  // The page is verified by whoever waits for the read, once it has completed.
+  return std::async(std::launch::deferred, [this, page_id, page_data, read = std::move(read)]() mutable {
+    return read.get() && VerifyPage(page_id, page_data);
+  });
+}
+
+/**
+ * Register a memory area with the backend of every data file, the stream has no use for it
+ */
+bool DiskManager::RegisterBuffer(char *data, size_t size) {
+  bool registered = false;
+  for (auto &file : data_files_) {
+    registered = (file->backend_ != nullptr && file->backend_->RegisterBuffer(data, size)) || registered;
+  }
+  return registered;
+}
+
+/**
+ * Unregister a memory area from the backend of every data file
+ */
+void DiskManager::UnregisterBuffer(char *data) {
+  for (auto &file : data_files_) {
+    if (file->backend_ != nullptr) {
+      file->backend_->UnregisterBuffer(data);
+    }
+  }
+}
+
+/**
+ * Private helper function to verify the checksum of a page that was read
+ */
+bool DiskManager::VerifyPage(page_id_t page_id, const char *page_data) {
+  if (checksums_->Verify(page_id, page_data)) {
+    return true;
+  }
+  num_corrupt_pages_ += 1;
+  LOG_WARN("page %d is corrupt, its checksum does not match", page_id);
+  return false;
+}
+
+/**
+ * Verify every page of the data files, a stripe at a time
+ */
+int DiskManager::ScrubPages() {
+  int num_corrupt = 0;
+  std::unique_ptr<char[]> buffer(new char[EXTENT_SIZE * PAGE_SIZE]);
+  for (size_t i = 0; i < data_files_.size() && !scrubber_shutdown_; i++) {
+    CompressedPageFile *compressed = data_files_[i]->compressed_.get();
+    if (compressed != nullptr) {
+      // The compressed pages are decompressed a stripe at a time.
+      std::vector<char *> pages;
+      for (page_id_t page = 0; page < EXTENT_SIZE; page++) {
+        pages.push_back(buffer.get() + page * PAGE_SIZE);
+      }
+      page_id_t num_pages = compressed->GetNumPages();
+      for (page_id_t first = 0; first < num_pages && !scrubber_shutdown_; first += EXTENT_SIZE) {
+        compressed->ReadPages(first, pages);
+        for (page_id_t file_page_id = first; file_page_id < first + EXTENT_SIZE; file_page_id++) {
+          page_id_t page_id = GetPageId(i, file_page_id);
+          if (!checksums_->Verify(page_id, pages[file_page_id - first]) && !RecheckPage(i, -1, file_page_id)) {
+            num_corrupt++;
+            num_corrupt_pages_ += 1;
+            LOG_WARN("page %d is corrupt, its checksum does not match", page_id);
+          }
+        }
+      }
+      continue;
+    }
+    int fd = open(data_files_[i]->name_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      continue;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    for (off_t offset = 0; !scrubber_shutdown_; offset += EXTENT_SIZE * PAGE_SIZE) {
+      ssize_t size = pread(fd, buffer.get(), EXTENT_SIZE * PAGE_SIZE, offset);
+      if (size < 0 && errno == EINTR) {
+        offset -= EXTENT_SIZE * PAGE_SIZE;
+        continue;
+      }
+      if (size < PAGE_SIZE) {
+        break;
+      }
+      auto file_page_id = static_cast<page_id_t>(offset / PAGE_SIZE);
+      for (ssize_t page = 0; page < size / PAGE_SIZE; page++, file_page_id++) {
+        page_id_t page_id = GetPageId(i, file_page_id);
+        if (!checksums_->Verify(page_id, buffer.get() + page * PAGE_SIZE) && !RecheckPage(i, fd, file_page_id)) {
+          num_corrupt++;
+          num_corrupt_pages_ += 1;
+          LOG_WARN("page %d is corrupt, its checksum does not match", page_id);
+        }
+      }
+      // The pages are not read again soon, leave the page cache to the rest of the system.
+      posix_fadvise(fd, offset, size, POSIX_FADV_DONTNEED);
+    }
+    close(fd);
+  }
+  return num_corrupt;
+}
+
+/**
+ * Private helper function to read a page that failed verification while scrubbing again. The page may have been read
+ * while it was being written, so it is only corrupt if it keeps failing.
+ */
+bool DiskManager::RecheckPage(size_t file_index, int fd, page_id_t file_page_id) {
+  CompressedPageFile *compressed = data_files_[file_index]->compressed_.get();
+  page_id_t page_id = GetPageId(file_index, file_page_id);
+  std::vector<char> data(PAGE_SIZE);
+  for (int attempt = 0; attempt < 3; attempt++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    bool read = compressed != nullptr
+                    ? compressed->ReadPage(file_page_id, data.data())
+                    : pread(fd, data.data(), PAGE_SIZE, static_cast<off_t>(file_page_id) * PAGE_SIZE) == PAGE_SIZE;
+    if (read && checksums_->Verify(page_id, data.data())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Start the scrubber thread, which scrubs the data files once every interval
+ */
+void DiskManager::RunScrubber(std::chrono::milliseconds interval) {
+  std::scoped_lock scrubber_lock{scrubber_latch_};
+  if (scrubber_thread_.joinable()) {
+    return;
+  }
+  scrubber_shutdown_ = false;
+  scrubber_thread_ = std::thread([this, interval] {
+    std::unique_lock scrubber_lock{scrubber_latch_};
+    while (!scrubber_shutdown_) {
+      scrubber_lock.unlock();
+      ScrubPages();
+      scrubber_lock.lock();
+      scrubber_cv_.wait_for(scrubber_lock, interval, [this] { return scrubber_shutdown_.load(); });
+    }
+  });
+}
+
+/**
+ * Stop the scrubber thread
+ */
+void DiskManager::StopScrubber() {
+  std::thread scrubber_thread;
+  {
+    std::scoped_lock scrubber_lock{scrubber_latch_};
+    scrubber_shutdown_ = true;
+    scrubber_thread = std::move(scrubber_thread_);
+  }
+  scrubber_cv_.notify_all();
+  if (scrubber_thread.joinable()) {
+    scrubber_thread.join();
+  }
+  scrubber_shutdown_ = false;
 }
 
 /**
@@ -186,16 +743,25 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
 
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * Reuses the lowest deallocated page before growing the file
+ */
+page_id_t DiskManager::AllocatePage(uint32_t stride, uint32_t offset) { return free_pages_->Allocate(stride, offset); }
+
+/**
+ * Allocate a run of contiguous pages (extent of a table heap or index)
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+page_id_t DiskManager::AllocateExtent(uint32_t num_pages) { return free_pages_->AllocateExtent(num_pages); }
 
 /**
  * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * The page is handed out again by a later allocation
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+void DiskManager::DeallocatePage(page_id_t page_id) { free_pages_->Deallocate(page_id); }
+
+/**
+ * Returns whether a page is allocated
+ */
+bool DiskManager::IsAllocated(page_id_t page_id) { return free_pages_->IsAllocated(page_id); }
 
 /**
  * Returns number of flushes made so far
@@ -203,22 +769,54 @@ void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
 int DiskManager::GetNumFlushes() const { return num_flushes_; }
 
 /**
- * Returns number of Writes made so far
+ * Returns number of Writes made so far, to all data files
+ */
+int DiskManager::GetNumWrites() const {
+  int num_writes = 0;
+  for (const auto &file : data_files_) {
+    num_writes += file->num_writes_;
+  }
+  return num_writes;
+}
+
+/**
+ * Returns number of page reads made so far, from all data files
  */
-int DiskManager::GetNumWrites() const { return num_writes_; }
+int DiskManager::GetNumReads() const {
+  int num_reads = 0;
+  for (const auto &file : data_files_) {
+    num_reads += file->num_reads_;
+  }
+  return num_reads;
+}
 
 /**
  * Returns true if the log is currently being flushed
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to sync a data file, through the backend's descriptor if there is one
+ */
+void DiskManager::SyncFile(DataFile *file) {
+  if (file->fd_ >= 0) {
+    fdatasync(file->fd_);
+    return;
+  }
+  int fd = open(file->name_.c_str(), O_RDWR);
+  if (fd >= 0) {
+    fdatasync(fd);
+    close(fd);
+  }
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+off_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? stat_buf.st_size : -1;
 }
 
 }  // namespace bustub
@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_bitmap.cpp
+//
+// Identification: src/storage/disk/free_page_bitmap.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_bitmap.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+FreePageBitmap::FreePageBitmap(std::string file_name, page_id_t num_pages, bool reset, page_id_t capacity)
+    : file_name_(std::move(file_name)), capacity_(capacity) {
+  if (file_name_.empty()) {
+    return;
+  }
+  if (reset) {
+    remove(file_name_.c_str());
+  }
+  io_.open(file_name_, std::ios::binary | std::ios::in | std::ios::out);
+  if (!io_.is_open()) {
+    // No page has been deallocated yet, so every page of the database file is allocated.
+    io_.clear();
+    words_.assign((num_pages + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      words_[page_id / BITS_PER_WORD] |= uint64_t{1} << (page_id % BITS_PER_WORD);
+    }
+    first_free_word_ = num_pages / BITS_PER_WORD;
+    return;
+  }
+  io_.seekg(0, std::ios::end);
+  size_t file_size = io_.tellg();
+  words_.assign(file_size / sizeof(uint64_t), 0);
+  io_.seekg(0);
+  io_.read(reinterpret_cast<char *>(words_.data()), words_.size() * sizeof(uint64_t));
+  if (io_.bad()) {
+    throw Exception("can't read free page bitmap");
+  }
+  io_.clear();
+}
+
+page_id_t FreePageBitmap::Allocate(uint32_t stride, uint32_t offset) {
+  std::scoped_lock lock{latch_};
+  while (first_free_word_ < words_.size() && words_[first_free_word_] == ~uint64_t{0}) {
+    first_free_word_++;
+  }
+  // Start at the first candidate in the first word that may have a free bit.
+  auto page_id = static_cast<page_id_t>(first_free_word_ * BITS_PER_WORD);
+  page_id += static_cast<page_id_t>((offset + stride - page_id % stride) % stride);
+  while (TestBit(page_id)) {
+    if (words_[page_id / BITS_PER_WORD] == ~uint64_t{0}) {
+      // Skip the rest of a full word, to its first candidate.
+      auto next_word = static_cast<page_id_t>((page_id / BITS_PER_WORD + 1) * BITS_PER_WORD);
+      page_id += (next_word - page_id + stride - 1) / stride * stride;
+    } else {
+      page_id += stride;
+    }
+  }
+  if (page_id >= capacity_) {
+    return INVALID_PAGE_ID;
+  }
+  UpdateBits(page_id, 1, true);
+  return page_id;
+}
+
+page_id_t FreePageBitmap::AllocateExtent(uint32_t num_pages) {
+  std::scoped_lock lock{latch_};
+  auto page_id = static_cast<page_id_t>(first_free_word_ * BITS_PER_WORD / num_pages * num_pages);
+  for (;; page_id += num_pages) {
+    uint32_t i = 0;
+    while (i < num_pages && !TestBit(page_id + i)) {
+      i++;
+    }
+    if (i == num_pages) {
+      break;
+    }
+  }
+  if (page_id > capacity_ - static_cast<page_id_t>(num_pages)) {
+    return INVALID_PAGE_ID;
+  }
+  UpdateBits(page_id, num_pages, true);
+  return page_id;
+}
+
+void FreePageBitmap::Deallocate(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  if (page_id < 0 || !TestBit(page_id)) {
+    return;
+  }
+  UpdateBits(page_id, 1, false);
+  first_free_word_ = std::min<size_t>(first_free_word_, page_id / BITS_PER_WORD);
+}
+
+bool FreePageBitmap::IsAllocated(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  return page_id >= 0 && TestBit(page_id);
+}
+
+void FreePageBitmap::Sync() {
+  std::scoped_lock lock{latch_};
+  if (!io_.is_open()) {
+    return;
+  }
+  io_.flush();
+  // The stream has no descriptor of its own to sync.
+  int fd = open(file_name_.c_str(), O_RDWR);
+  if (fd >= 0) {
+    fdatasync(fd);
+    close(fd);
+  }
+}
+
+void FreePageBitmap::Close() {
+  std::scoped_lock lock{latch_};
+  io_.close();
+}
+
+bool FreePageBitmap::TestBit(page_id_t page_id) const {
+  size_t word = page_id / BITS_PER_WORD;
+  return word < words_.size() && (words_[word] & (uint64_t{1} << (page_id % BITS_PER_WORD))) != 0;
+}
+
+void FreePageBitmap::UpdateBits(page_id_t first_page_id, uint32_t num_pages, bool allocated) {
+  size_t last_word = (first_page_id + num_pages - 1) / BITS_PER_WORD;
+  if (last_word >= words_.size()) {
+    words_.resize(last_word + 1, 0);
+  }
+  for (page_id_t page_id = first_page_id; page_id < first_page_id + static_cast<page_id_t>(num_pages); page_id++) {
+    uint64_t mask = uint64_t{1} << (page_id % BITS_PER_WORD);
+    uint64_t &word = words_[page_id / BITS_PER_WORD];
+    word = allocated ? word | mask : word & ~mask;
+  }
+  // Before the first deallocation the bitmap can be rebuilt from the size of the database file.
+  if (!file_name_.empty() && (io_.is_open() || !allocated)) {
+    for (size_t page = first_page_id / BITS_PER_BITMAP_PAGE; page <= last_word / WORDS_PER_BITMAP_PAGE; page++) {
+      WriteBitmapPage(page);
+    }
+  }
+}
+
+void FreePageBitmap::WriteBitmapPage(size_t bitmap_page) {
+  if (!io_.is_open()) {
+    // Create the file with every bitmap page so far, the bits of the pages below the highest one are set.
+    io_.open(file_name_, std::ios::binary | std::ios::trunc | std::ios::in | std::ios::out);
+    if (!io_.is_open()) {
+      LOG_DEBUG("can't create free page bitmap file");
+      return;
+    }
+    for (size_t page = 0; page < bitmap_page; page++) {
+      WriteBitmapPage(page);
+    }
+  }
+  // The file always holds whole bitmap pages, the words past the end of the bitmap are zero.
+  std::vector<uint64_t> data(WORDS_PER_BITMAP_PAGE, 0);
+  size_t first_word = bitmap_page * WORDS_PER_BITMAP_PAGE;
+  for (size_t i = 0; i < WORDS_PER_BITMAP_PAGE && first_word + i < words_.size(); i++) {
+    data[i] = words_[first_word + i];
+  }
+  io_.seekp(bitmap_page * PAGE_SIZE);
+  io_.write(reinterpret_cast<const char *>(data.data()), PAGE_SIZE);
+  if (io_.bad()) {
+    LOG_DEBUG("I/O error while writing free page bitmap");
+    return;
+  }
+  io_.flush();
+}
+
+}  // namespace bustub
@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring_disk_backend.cpp
+//
+// Identification: src/storage/disk/io_uring_disk_backend.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/io_uring_disk_backend.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+/** The kernel limits a registered buffer to 1 GiB, larger areas are registered in pieces. */
+constexpr size_t MAX_REGISTERED_BUFFER_SIZE = size_t{1} << 30;
+
+int IoUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int ring_fd, unsigned opcode, void *arg, unsigned nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+/** Pointer to a field of a ring mapping. */
+template <typename T>
+T *RingField(void *ring, unsigned offset) {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}  // namespace
+
+IoUringDiskBackend::IoUringDiskBackend(int fd, unsigned queue_depth) : fd_(fd) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = IoUringSetup(queue_depth, &params);
+  if (ring_fd_ < 0) {
+    throw Exception("can't set up io_uring: " + std::string(strerror(errno)));
+  }
+  sq_entries_ = params.sq_entries;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    close(ring_fd_);
+    throw Exception("can't map io_uring submission queue");
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+    cq_ring_size_ = 0;
+  } else {
+    cq_ring_ =
+        mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+      close(ring_fd_);
+      throw Exception("can't map io_uring completion queue");
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (!single_mmap) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd_);
+    throw Exception("can't map io_uring submission queue entries");
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  sq_tail_ = RingField<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = RingField<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_array_ = RingField<unsigned>(sq_ring_, params.sq_off.array);
+  cq_head_ = RingField<unsigned>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingField<unsigned>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = RingField<unsigned>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+  completion_thread_ = std::thread(&IoUringDiskBackend::RunCompletions, this);
+}
+
+IoUringDiskBackend::~IoUringDiskBackend() {
+  {
+    std::unique_lock lock{latch_};
+    slot_freed_.wait(lock, [this] { return in_flight_ == 0; });
+    // The completion thread exits once it reaps this no-op.
+    in_flight_++;
+    Submit(IORING_OP_NOP, nullptr);
+  }
+  completion_thread_.join();
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+}
+
+void IoUringDiskBackend::Schedule(DiskRequest request) {
+  auto *pending = new PendingRequest{std::move(request)};
+  std::unique_lock lock{latch_};
+  slot_freed_.wait(lock, [this] { return in_flight_ < sq_entries_; });
+  in_flight_++;
+  Submit(pending->request_.is_write_ ? IORING_OP_WRITE : IORING_OP_READ, pending);
+}
+
+void IoUringDiskBackend::Submit(uint8_t opcode, PendingRequest *pending) {
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd_;
+  sqe->user_data = reinterpret_cast<uint64_t>(pending);
+  if (pending != nullptr) {
+    DiskRequest *request = &pending->request_;
+    sqe->addr = reinterpret_cast<uint64_t>(request->data_ + pending->num_done_);
+    sqe->len = PAGE_SIZE - pending->num_done_;
+    sqe->off = static_cast<uint64_t>(request->page_id_) * PAGE_SIZE + pending->num_done_;
+    // Use the fixed-buffer operation if the page lies in a registered buffer.
+    for (size_t i = 0; i < buffers_.size(); i++) {
+      char *base = static_cast<char *>(buffers_[i].iov_base);
+      if (request->data_ >= base && request->data_ + PAGE_SIZE <= base + buffers_[i].iov_len) {
+        sqe->opcode = request->is_write_ ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->buf_index = static_cast<uint16_t>(i);
+        break;
+      }
+    }
+  }
+  sq_array_[index] = index;
+  // The entry has to be visible to the kernel before the new tail.
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  int ret;
+  do {
+    ret = IoUringEnter(ring_fd_, 1, 0, 0);
+  } while (ret < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY));
+  BUSTUB_ASSERT(ret == 1, "io_uring did not accept the submission.");
+}
+
+void IoUringDiskBackend::RunCompletions() {
+  bool shutdown = false;
+  while (!shutdown) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+      continue;
+    }
+    unsigned num_reaped = 0;
+    for (; head != tail; head++) {
+      io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+      auto *pending = reinterpret_cast<PendingRequest *>(cqe->user_data);
+      if (pending == nullptr) {
+        num_reaped++;
+        shutdown = true;
+        continue;
+      }
+      if (Complete(pending, cqe->res)) {
+        num_reaped++;
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    {
+      std::scoped_lock lock{latch_};
+      in_flight_ -= num_reaped;
+    }
+    slot_freed_.notify_all();
+  }
+}
+
+bool IoUringDiskBackend::Complete(PendingRequest *pending, int res) {
+  DiskRequest *request = &pending->request_;
+  bool success = true;
+  if (res == -EINTR || res == -EAGAIN) {
+    res = 0;
+  } else if (res < 0) {
+    LOG_DEBUG("I/O error while %s page %d: %s", request->is_write_ ? "writing" : "reading", request->page_id_,
+              strerror(-res));
+    success = false;
+  } else if (res == 0 && !request->is_write_) {
+    // A read of nothing means the file ends here, the rest of the page reads as zeros.
+    memset(request->data_ + pending->num_done_, 0, PAGE_SIZE - pending->num_done_);
+    pending->num_done_ = PAGE_SIZE;
+  } else if (res == 0) {
+    LOG_DEBUG("I/O error while writing page %d: no progress", request->page_id_);
+    success = false;
+  }
+  pending->num_done_ += static_cast<uint32_t>(std::max(res, 0));
+  if (success && pending->num_done_ < PAGE_SIZE) {
+    // A short transfer, or one that was interrupted, goes on with the rest of the page in the same slot.
+    std::scoped_lock lock{latch_};
+    Submit(request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ, pending);
+    return false;
+  }
+  request->callback_.set_value(success);
+  delete pending;
+  return true;
+}
+
+bool IoUringDiskBackend::RegisterBuffer(char *data, size_t size) {
+  std::unique_lock lock{latch_};
+  // Older kernels cannot update the buffer table while fixed-buffer operations are in flight.
+  slot_freed_.wait(lock, [this] { return in_flight_ == 0; });
+  for (size_t offset = 0; offset < size; offset += MAX_REGISTERED_BUFFER_SIZE) {
+    buffers_.push_back({data + offset, std::min(size - offset, MAX_REGISTERED_BUFFER_SIZE)});
+  }
+  if (UpdateRegisteredBuffers()) {
+    return true;
+  }
+  // Pinning the buffer may be over the locked memory limit, in which case requests use ordinary operations.
+  buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                [&](const iovec &buffer) {
+                                  char *base = static_cast<char *>(buffer.iov_base);
+                                  return base >= data && base < data + size;
+                                }),
+                 buffers_.end());
+  UpdateRegisteredBuffers();
+  return false;
+}
+
+void IoUringDiskBackend::UnregisterBuffer(char *data) {
+  std::unique_lock lock{latch_};
+  // Fixed-buffer operations in flight may still use the buffer.
+  slot_freed_.wait(lock, [this] { return in_flight_ == 0; });
+  auto iter = std::find_if(buffers_.begin(), buffers_.end(),
+                           [&](const iovec &buffer) { return buffer.iov_base == data; });
+  if (iter == buffers_.end()) {
+    return;
+  }
+  auto last = iter;
+  while (last != buffers_.end() &&
+         static_cast<char *>(last->iov_base) == data + (last - iter) * MAX_REGISTERED_BUFFER_SIZE) {
+    last++;
+  }
+  buffers_.erase(iter, last);
+  UpdateRegisteredBuffers();
+}
+
+bool IoUringDiskBackend::UpdateRegisteredBuffers() {
+  IoUringRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+  if (buffers_.empty()) {
+    return true;
+  }
+  if (IoUringRegister(ring_fd_, IORING_REGISTER_BUFFERS, buffers_.data(), buffers_.size()) < 0) {
+    LOG_DEBUG("can't register io_uring buffers: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace bustub
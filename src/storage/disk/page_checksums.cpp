@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_checksums.cpp
+//
+// Identification: src/storage/disk/page_checksums.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_checksums.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/util/checksum_util.h"
+
+namespace bustub {
+
+PageChecksums::PageChecksums(std::string file_name, bool reset) : file_name_(std::move(file_name)) {
+  if (file_name_.empty()) {
+    return;
+  }
+  if (reset) {
+    remove(file_name_.c_str());
+  }
+  io_.open(file_name_, std::ios::binary | std::ios::in | std::ios::out);
+  if (!io_.is_open()) {
+    io_.clear();
+    io_.open(file_name_, std::ios::binary | std::ios::trunc | std::ios::in | std::ios::out);
+    if (!io_.is_open()) {
+      throw Exception("can't open checksum file");
+    }
+    return;
+  }
+  io_.seekg(0, std::ios::end);
+  size_t file_size = io_.tellg();
+  checksums_.assign(file_size / sizeof(uint32_t), 0);
+  io_.seekg(0);
+  io_.read(reinterpret_cast<char *>(checksums_.data()), checksums_.size() * sizeof(uint32_t));
+  if (io_.bad()) {
+    throw Exception("can't read checksum file");
+  }
+  io_.clear();
+}
+
+void PageChecksums::Update(page_id_t page_id, const char *data) {
+  uint32_t checksum = Compute(data);
+  std::scoped_lock lock{latch_};
+  if (static_cast<size_t>(page_id) >= checksums_.size()) {
+    checksums_.resize(page_id + 1, 0);
+  }
+  checksums_[page_id] = checksum;
+  WriteChecksums(page_id, 1);
+}
+
+void PageChecksums::Update(const std::vector<std::pair<page_id_t, const char *>> &pages) {
+  if (pages.empty()) {
+    return;
+  }
+  std::vector<uint32_t> checksums;
+  checksums.reserve(pages.size());
+  for (auto [page_id, data] : pages) {
+    checksums.push_back(Compute(data));
+  }
+  std::scoped_lock lock{latch_};
+  if (static_cast<size_t>(pages.back().first) >= checksums_.size()) {
+    checksums_.resize(pages.back().first + 1, 0);
+  }
+  size_t run_start = 0;
+  for (size_t i = 0; i < pages.size(); i++) {
+    checksums_[pages[i].first] = checksums[i];
+    if (i + 1 == pages.size() || pages[i + 1].first != pages[i].first + 1) {
+      WriteChecksums(pages[run_start].first, i + 1 - run_start);
+      run_start = i + 1;
+    }
+  }
+}
+
+bool PageChecksums::Verify(page_id_t page_id, const char *data) {
+  uint32_t checksum;
+  {
+    std::scoped_lock lock{latch_};
+    if (static_cast<size_t>(page_id) >= checksums_.size() || checksums_[page_id] == 0) {
+      return true;
+    }
+    checksum = checksums_[page_id];
+  }
+  return Compute(data) == checksum;
+}
+
+void PageChecksums::Sync() {
+  std::scoped_lock lock{latch_};
+  if (!io_.is_open()) {
+    return;
+  }
+  io_.flush();
+  // The stream has no descriptor of its own to sync.
+  int fd = open(file_name_.c_str(), O_RDWR);
+  if (fd >= 0) {
+    fdatasync(fd);
+    close(fd);
+  }
+}
+
+void PageChecksums::Close() {
+  std::scoped_lock lock{latch_};
+  io_.close();
+}
+
+uint32_t PageChecksums::Compute(const char *data) {
+  uint32_t checksum = ChecksumUtil::Crc32c(data, PAGE_SIZE);
+  // 0 marks a page without a checksum.
+  return checksum == 0 ? 1 : checksum;
+}
+
+void PageChecksums::WriteChecksums(page_id_t first_page_id, size_t num_pages) {
+  if (!io_.is_open()) {
+    return;
+  }
+  io_.seekp(static_cast<size_t>(first_page_id) * sizeof(uint32_t));
+  io_.write(reinterpret_cast<const char *>(&checksums_[first_page_id]), num_pages * sizeof(uint32_t));
+  if (io_.bad()) {
+    LOG_DEBUG("I/O error while writing page checksums");
+    return;
+  }
+  io_.flush();
+}
+
+}  // namespace bustub
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posix_disk_backend.cpp
+//
+// Identification: src/storage/disk/posix_disk_backend.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/posix_disk_backend.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+/** Direct I/O requires buffers aligned to the logical block size of the device, a page is aligned to all of them. */
+constexpr size_t DIRECT_IO_ALIGNMENT = PAGE_SIZE;
+
+struct FreeDeleter {
+  void operator()(char *data) const { free(data); }
+};
+
+}  // namespace
+
+void PosixDiskBackend::Schedule(DiskRequest request) {
+  bool success;
+  if (reinterpret_cast<uintptr_t>(request.data_) % DIRECT_IO_ALIGNMENT == 0) {
+    success = Transfer(request.is_write_, request.page_id_, request.data_);
+  } else {
+    std::unique_ptr<char, FreeDeleter> bounce(static_cast<char *>(aligned_alloc(DIRECT_IO_ALIGNMENT, PAGE_SIZE)));
+    if (request.is_write_) {
+      memcpy(bounce.get(), request.data_, PAGE_SIZE);
+    }
+    success = Transfer(request.is_write_, request.page_id_, bounce.get());
+    if (!request.is_write_) {
+      memcpy(request.data_, bounce.get(), PAGE_SIZE);
+    }
+  }
+  request.callback_.set_value(success);
+}
+
+bool PosixDiskBackend::WritePages(const std::vector<std::pair<page_id_t, char *>> &pages) {
+  bool success = true;
+  std::vector<iovec> run;
+  page_id_t run_start = INVALID_PAGE_ID;
+  for (size_t i = 0; i < pages.size(); i++) {
+    auto [page_id, data] = pages[i];
+    if (reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT != 0) {
+      // Only aligned buffers can be written in place, the others go through the bounce buffer one at a time.
+      DiskRequest request{true, page_id, data, {}};
+      auto write = request.callback_.get_future();
+      Schedule(std::move(request));
+      success = write.get() && success;
+      continue;
+    }
+    if (run.empty()) {
+      run_start = page_id;
+    }
+    run.push_back({data, static_cast<size_t>(PAGE_SIZE)});
+    if (i + 1 == pages.size() || pages[i + 1].first != page_id + 1 ||
+        reinterpret_cast<uintptr_t>(pages[i + 1].second) % DIRECT_IO_ALIGNMENT != 0) {
+      success = WriteRun(run_start, &run) && success;
+      run.clear();
+    }
+  }
+  return success;
+}
+
+bool PosixDiskBackend::WriteRun(page_id_t page_id, std::vector<iovec> *page_data) {
+  off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+  iovec *iov = page_data->data();
+  size_t num_iov = page_data->size();
+  while (num_iov > 0) {
+    ssize_t ret = pwritev(fd_, iov, static_cast<int>(std::min<size_t>(num_iov, IOV_MAX)), offset);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      LOG_DEBUG("I/O error while writing pages from %d: %s", page_id, strerror(errno));
+      return false;
+    }
+    offset += ret;
+    // Skip the buffers that were written completely, and the written part of a buffer that was written partially.
+    while (num_iov > 0 && static_cast<size_t>(ret) >= iov->iov_len) {
+      ret -= iov->iov_len;
+      iov++;
+      num_iov--;
+    }
+    if (num_iov > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + ret;
+      iov->iov_len -= ret;
+    }
+  }
+  return true;
+}
+
+bool PosixDiskBackend::Transfer(bool is_write, page_id_t page_id, char *data) {
+  off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+  size_t done = 0;
+  while (done < static_cast<size_t>(PAGE_SIZE)) {
+    ssize_t ret = is_write ? pwrite(fd_, data + done, PAGE_SIZE - done, offset + done)
+                           : pread(fd_, data + done, PAGE_SIZE - done, offset + done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      LOG_DEBUG("I/O error while %s page %d: %s", is_write ? "writing" : "reading", page_id, strerror(errno));
+      return false;
+    }
+    if (ret == 0) {
+      if (is_write) {
+        LOG_DEBUG("I/O error while writing: wrote less than a page");
+        return false;
+      }
+      // The file ends before the page does.
+      memset(data + done, 0, PAGE_SIZE - done);
+      return true;
+    }
+    done += ret;
+  }
+  return true;
+}
+
+}  // namespace bustub
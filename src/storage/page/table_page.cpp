@@ -12,7 +12,11 @@
 
 #include "storage/page/table_page.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace bustub {
 
@@ -85,6 +89,21 @@ bool TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   return true;
 }
 
+bool TablePage::AppendTuple(const Tuple &tuple, RID *rid) {
+  BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+    return false;
+  }
+  uint32_t slot_num = GetTupleCount();
+  SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+  memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, tuple.size_);
+  SetTupleCount(slot_num + 1);
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
 bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort the transaction.
@@ -197,7 +216,7 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   return true;
 }
 
-void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple) {
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -242,6 +261,9 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
       SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
     }
   }
+  if (deleted_tuple != nullptr) {
+    *deleted_tuple = delete_tuple;
+  }
 }
 
 void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
@@ -305,6 +327,45 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
+uint32_t TablePage::Compact() {
+  uint32_t old_free_space = GetFreeSpaceRemaining();
+
+  // Move the tuples towards the end of the page from the last one backwards, so that no tuple is overwritten before it
+  // has moved.
+  std::vector<std::pair<uint32_t, uint32_t>> tuples;  // (offset, slot)
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    if (GetTupleSize(i) != 0) {
+      tuples.emplace_back(GetTupleOffsetAtSlot(i), i);
+    }
+  }
+  std::sort(tuples.begin(), tuples.end(), std::greater<>());
+  uint32_t free_space_pointer = PAGE_SIZE;
+  for (const auto &[offset, slot_num] : tuples) {
+    uint32_t tuple_size = UnsetDeletedFlag(GetTupleSize(slot_num));
+    free_space_pointer -= tuple_size;
+    memmove(GetData() + free_space_pointer, GetData() + offset, tuple_size);
+    SetTupleOffsetAtSlot(slot_num, free_space_pointer);
+  }
+  SetFreeSpacePointer(free_space_pointer);
+
+  // Empty slots in the middle keep their place for the rids after them, the ones at the end can go.
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+  return GetFreeSpaceRemaining() - old_free_space;
+}
+
+bool TablePage::IsEmpty() {
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    if (GetTupleSize(i) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool TablePage::GetFirstTupleRid(RID *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
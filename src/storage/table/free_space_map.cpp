@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {
+  auto guard = buffer_pool_manager_->NewPageGuarded(&first_page_id_).UpgradeWrite();
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't create a page for the free space map.");
+  static_cast<FreeSpaceMapPage *>(guard.GetPage())->Init(first_page_id_);
+  guard.SetDirty();
+  last_page_id_ = first_page_id_;
+  next_page_id_ = first_page_id_;
+}
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id)
+    : buffer_pool_manager_(buffer_pool_manager), first_page_id_(first_page_id), next_page_id_(first_page_id) {
+  // Find the last page, which new table pages are added to.
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the free space map.");
+    last_page_id_ = page_id;
+    page_id = static_cast<FreeSpaceMapPage *>(guard.GetPage())->GetNextPageId();
+  }
+}
+
+bool FreeSpaceMap::FindPage(uint32_t size, Entry *entry) {
+  uint32_t min_category = FreeSpaceMapPage::ToMinCategory(size);
+  if (min_category > UINT8_MAX) {
+    return false;
+  }
+  page_id_t start_page_id;
+  uint32_t start_index;
+  {
+    std::scoped_lock latch(latch_);
+    start_page_id = next_page_id_;
+    start_index = next_index_;
+  }
+  // Search from where the last search stopped, so that the pages filled before are not checked again and again, then
+  // from the start of the map for the pages that were given free space since.
+  bool wrapped = start_page_id != first_page_id_ || start_index != 0;
+  bool found = FindPage(min_category, start_page_id, start_index, entry) ||
+               (wrapped && FindPage(min_category, first_page_id_, 0, entry));
+  if (found) {
+    std::scoped_lock latch(latch_);
+    next_page_id_ = entry->map_page_id_;
+    next_index_ = entry->index_;
+  }
+  return found;
+}
+
+bool FreeSpaceMap::FindPage(uint32_t min_category, page_id_t start_page_id, uint32_t start_index, Entry *entry) {
+  auto page_id = start_page_id;
+  auto index = start_index;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the free space map.");
+    auto page = static_cast<FreeSpaceMapPage *>(guard.GetPage());
+    index = page->Find(min_category, index);
+    if (index < page->GetEntryCount()) {
+      entry->map_page_id_ = page_id;
+      entry->index_ = index;
+      entry->table_page_id_ = page->GetTablePageId(index);
+      return true;
+    }
+    page_id = page->GetNextPageId();
+    index = 0;
+  }
+  return false;
+}
+
+bool FreeSpaceMap::FindEntry(page_id_t table_page_id, Entry *entry) {
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the free space map.");
+    auto page = static_cast<FreeSpaceMapPage *>(guard.GetPage());
+    auto index = page->IndexOf(table_page_id);
+    if (index < page->GetEntryCount()) {
+      entry->map_page_id_ = page_id;
+      entry->index_ = index;
+      entry->table_page_id_ = table_page_id;
+      return true;
+    }
+    page_id = page->GetNextPageId();
+  }
+  return false;
+}
+
+void FreeSpaceMap::Update(const Entry &entry, uint32_t free_space) {
+  auto guard = buffer_pool_manager_->FetchPageWrite(entry.map_page_id_);
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the free space map.");
+  static_cast<FreeSpaceMapPage *>(guard.GetPage())->SetFreeSpace(entry.index_, free_space);
+  guard.SetDirty();
+}
+
+void FreeSpaceMap::Remove(const Entry &entry) {
+  auto guard = buffer_pool_manager_->FetchPageWrite(entry.map_page_id_);
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the free space map.");
+  static_cast<FreeSpaceMapPage *>(guard.GetPage())->Remove(entry.index_);
+  guard.SetDirty();
+}
+
+void FreeSpaceMap::GetEntries(std::vector<Entry> *entries) {
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the free space map.");
+    auto page = static_cast<FreeSpaceMapPage *>(guard.GetPage());
+    for (uint32_t index = 0; index < page->GetEntryCount(); index++) {
+      if (page->GetTablePageId(index) != INVALID_PAGE_ID) {
+        entries->push_back(Entry{page_id, index, page->GetTablePageId(index)});
+      }
+    }
+    page_id = page->GetNextPageId();
+  }
+}
+
+bool FreeSpaceMap::Add(page_id_t table_page_id, uint32_t free_space, Entry *entry) {
+  std::scoped_lock latch(latch_);
+  auto last_guard = buffer_pool_manager_->FetchPageWrite(last_page_id_);
+  BUSTUB_ASSERT(last_guard.IsValid(), "Couldn't fetch a page of the free space map.");
+  auto last_page = static_cast<FreeSpaceMapPage *>(last_guard.GetPage());
+  if (last_page->Append(table_page_id, free_space)) {
+    last_guard.SetDirty();
+    if (entry != nullptr) {
+      *entry = Entry{last_page_id_, last_page->GetEntryCount() - 1, table_page_id};
+    }
+    return true;
+  }
+  // The last page is full, chain a new one.
+  page_id_t new_page_id;
+  auto new_guard = buffer_pool_manager_->NewPageGuarded(&new_page_id).UpgradeWrite();
+  if (!new_guard.IsValid()) {
+    return false;
+  }
+  auto new_page = static_cast<FreeSpaceMapPage *>(new_guard.GetPage());
+  new_page->Init(new_page_id);
+  new_page->Append(table_page_id, free_space);
+  new_guard.SetDirty();
+  last_page->SetNextPageId(new_page_id);
+  last_guard.SetDirty();
+  last_page_id_ = new_page_id;
+  if (entry != nullptr) {
+    *entry = Entry{new_page_id, 0, table_page_id};
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
 
 #include "common/logger.h"
 #include "storage/table/table_heap.h"
@@ -18,92 +22,340 @@
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, page_id_t free_space_map_page_id, const Schema *schema)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      schema_(schema),
+      insert_targets_(std::max(MIN_INSERT_TARGETS, std::thread::hardware_concurrency())) {
+  if (free_space_map_page_id != INVALID_PAGE_ID) {
+    free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_, free_space_map_page_id);
+    return;
+  }
+  // Build the free space map from the pages of the table.
+  free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_);
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the table heap.");
+    auto page = static_cast<TablePage *>(guard.GetPage());
+    bool is_added = free_space_map_->Add(page_id, page->GetFreeSpaceRemaining());
+    BUSTUB_ASSERT(is_added, "Couldn't create a page for the free space map.");
+    last_page_id_ = page_id;
+    page_id = page->GetNextPageId();
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, const Schema *schema)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      schema_(schema),
+      insert_targets_(std::max(MIN_INSERT_TARGETS, std::thread::hardware_concurrency())) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
-  BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
-  first_page->WLatch();
+  auto guard = buffer_pool_manager_->NewPageGuarded(&first_page_id_, &extent_).UpgradeWrite();
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't create a page for the table heap.");
+  auto first_page = static_cast<TablePage *>(guard.GetPage());
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
-  first_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_);
+  bool is_added = free_space_map_->Add(first_page_id_, first_page->GetFreeSpaceRemaining());
+  BUSTUB_ASSERT(is_added, "Couldn't create a page for the free space map.");
+  last_page_id_ = first_page_id_;
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
-  if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+  Tuple small_tuple;
+  const Tuple *stored_tuple = PrepareTuple(tuple, &small_tuple, txn);
+  if (stored_tuple == nullptr) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
-    txn->SetState(TransactionState::ABORTED);
-    return false;
+  std::shared_lock reclaim_latch(reclaim_latch_);
+  // Insert into the target page of this thread while it has room.
+  auto target = GetInsertTarget();
+  FreeSpaceMap::Entry entry;
+  {
+    std::scoped_lock latch(target->latch_);
+    entry = target->entry_;
+  }
+  if (entry.table_page_id_ != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageWrite(entry.table_page_id_);
+    if (!guard.IsValid()) {
+      return AbortInsert(stored_tuple, small_tuple, txn);
+    }
+    auto page = static_cast<TablePage *>(guard.GetPage());
+    if (page->InsertTuple(*stored_tuple, rid, txn, lock_manager_, log_manager_)) {
+      guard.SetDirty();
+      guard.Drop();
+      // Update the transaction's write set.
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+    // The target page is full, hand it back to the free space map with the room it has left.
+    free_space_map_->Update(entry, page->GetFreeSpaceRemaining());
+    guard.Drop();
+    std::scoped_lock latch(target->latch_);
+    if (target->entry_.table_page_id_ == entry.table_page_id_) {
+      target->entry_ = FreeSpaceMap::Entry{};
+    }
   }
 
-  cur_page->WLatch();
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      // And repeat the process with the next page.
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      cur_page->WLatch();
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-        txn->SetState(TransactionState::ABORTED);
-        return false;
-      }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
-    }
-  }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+  // Then insert into a page the free space map says has room, which becomes the new target. The map is only a hint,
+  // so the page may turn out to be full, in which case its entry is corrected and we look again.
+  while (free_space_map_->FindPage(TablePage::GetSpaceNeeded(*stored_tuple), &entry)) {
+    auto guard = buffer_pool_manager_->FetchPageWrite(entry.table_page_id_);
+    if (!guard.IsValid()) {
+      return AbortInsert(stored_tuple, small_tuple, txn);
+    }
+    auto page = static_cast<TablePage *>(guard.GetPage());
+    if (page->InsertTuple(*stored_tuple, rid, txn, lock_manager_, log_manager_)) {
+      guard.SetDirty();
+      SetInsertTarget(target, entry, page->GetFreeSpaceRemaining());
+      guard.Drop();
+      // Update the transaction's write set.
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+    free_space_map_->Update(entry, page->GetFreeSpaceRemaining());
+  }
+
+  // No page has room, so the table grows by a page, which becomes the new target.
+  if (!AppendTuple(*stored_tuple, rid, txn, &entry)) {
+    return AbortInsert(stored_tuple, small_tuple, txn);
+  }
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
   return true;
 }
 
+TableHeap::InsertTarget *TableHeap::GetInsertTarget() {
+  // Number the threads as they first insert, so that concurrent threads get different targets.
+  static std::atomic<size_t> next_thread_index{0};
+  thread_local size_t thread_index = next_thread_index++;
+  return &insert_targets_[thread_index % insert_targets_.size()];
+}
+
+void TableHeap::SetInsertTarget(InsertTarget *target, const FreeSpaceMap::Entry &entry, uint32_t free_space) {
+  bool is_target;
+  {
+    std::scoped_lock latch(target->latch_);
+    is_target = target->entry_.table_page_id_ == INVALID_PAGE_ID;
+    if (is_target) {
+      target->entry_ = entry;
+    }
+  }
+  free_space_map_->Update(entry, is_target ? 0 : free_space);
+}
+
+bool TableHeap::AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn, FreeSpaceMap::Entry *entry) {
+  auto guard = AppendPage(txn);
+  if (!guard.IsValid()) {
+    return false;
+  }
+  auto page = static_cast<TablePage *>(guard.GetPage());
+  bool is_inserted = page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+  BUSTUB_ASSERT(is_inserted, "A new page has room for any tuple that fits in a page.");
+  guard.SetDirty();
+  // The page is added hidden, and shown if it cannot become the target of this thread.
+  if (!free_space_map_->Add(guard.PageId(), 0, entry)) {
+    return false;
+  }
+  SetInsertTarget(GetInsertTarget(), *entry, page->GetFreeSpaceRemaining());
+  return true;
+}
+
+WritePageGuard TableHeap::AppendPage(Transaction *txn) {
+  page_id_t new_page_id;
+  auto new_guard = buffer_pool_manager_->NewPageGuarded(&new_page_id, &extent_).UpgradeWrite();
+  if (!new_guard.IsValid()) {
+    return new_guard;
+  }
+  auto new_page = static_cast<TablePage *>(new_guard.GetPage());
+
+  // Link the new page after the last page. Other inserters may have linked pages after the page we start from, so
+  // follow the chain to its end. Nobody else knows the new page yet, so holding its latch cannot deadlock.
+  auto last_page_id = last_page_id_.load();
+  if (last_page_id == INVALID_PAGE_ID) {
+    last_page_id = first_page_id_;
+  }
+  while (true) {
+    auto last_guard = buffer_pool_manager_->FetchPageWrite(last_page_id);
+    if (!last_guard.IsValid()) {
+      new_guard.Drop();
+      buffer_pool_manager_->DeletePage(new_page_id);
+      return new_guard;
+    }
+    auto last_page = static_cast<TablePage *>(last_guard.GetPage());
+    auto next_page_id = last_page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      new_page->Init(new_page_id, PAGE_SIZE, last_page_id, log_manager_, txn);
+      last_page->SetNextPageId(new_page_id);
+      last_guard.SetDirty();
+      break;
+    }
+    last_page_id = next_page_id;
+  }
+  // Only a hint, so it does not matter if a concurrent append moved it further before.
+  last_page_id_.store(new_page_id);
+  new_guard.SetDirty();
+  return new_guard;
+}
+
+bool TableHeap::FinishBulkLoadPage(WritePageGuard *guard, Transaction *txn) {
+  auto page = static_cast<TablePage *>(guard->GetPage());
+  // One image of the whole page stands in for the log records of its tuples.
+  LogPageImage(guard, txn);
+  bool is_added = free_space_map_->Add(guard->PageId(), page->GetFreeSpaceRemaining());
+  guard->Drop();
+  return is_added;
+}
+
+const Tuple *TableHeap::PrepareTuple(const Tuple &tuple, Tuple *small_tuple, Transaction *txn) {
+  if (schema_ == nullptr || tuple.size_ <= OVERFLOW_THRESHOLD) {
+    return tuple.size_ + 32 > PAGE_SIZE ? nullptr : &tuple;
+  }
+  // Move the largest values first, so that as few values as possible have to be read from overflow pages.
+  std::vector<uint32_t> columns = schema_->GetUnlinedColumns();
+  std::sort(columns.begin(), columns.end(), [&tuple, this](uint32_t left, uint32_t right) {
+    return tuple.GetPayloadSize(schema_, left) > tuple.GetPayloadSize(schema_, right);
+  });
+  std::vector<page_id_t> overflow_page_ids(schema_->GetColumnCount(), INVALID_PAGE_ID);
+  uint32_t size = tuple.size_;
+  for (auto column_idx : columns) {
+    uint32_t payload_size = tuple.GetPayloadSize(schema_, column_idx);
+    if (size <= OVERFLOW_THRESHOLD || payload_size <= Tuple::OVERFLOW_PAYLOAD_SIZE) {
+      break;
+    }
+    const char *data = tuple.GetDataPtr(schema_, column_idx) + sizeof(uint32_t);
+    overflow_page_ids[column_idx] = WriteOverflowValue(data, payload_size - sizeof(uint32_t), txn);
+    if (overflow_page_ids[column_idx] == INVALID_PAGE_ID) {
+      size = PAGE_SIZE;
+      break;
+    }
+    size -= payload_size - Tuple::OVERFLOW_PAYLOAD_SIZE;
+  }
+  if (size + 32 > PAGE_SIZE) {
+    for (auto overflow_page_id : overflow_page_ids) {
+      DeleteOverflowValue(overflow_page_id);
+    }
+    return nullptr;
+  }
+  *small_tuple = tuple.MoveOutOfLine(schema_, overflow_page_ids);
+  return small_tuple;
+}
+
+bool TableHeap::AbortInsert(const Tuple *stored_tuple, const Tuple &small_tuple, Transaction *txn) {
+  // The values PrepareTuple moved out of line belong to no tuple of the table.
+  if (stored_tuple == &small_tuple) {
+    DeleteOverflowValues(small_tuple);
+  }
+  txn->SetState(TransactionState::ABORTED);
+  return false;
+}
+
+page_id_t TableHeap::WriteOverflowValue(const char *data, uint32_t size, Transaction *txn) {
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  WritePageGuard prev_guard;
+  for (uint32_t offset = 0; offset < size;) {
+    page_id_t page_id;
+    auto guard = buffer_pool_manager_->NewPageGuarded(&page_id, &overflow_extent_).UpgradeWrite();
+    if (!guard.IsValid()) {
+      prev_guard.Drop();
+      DeleteOverflowValue(first_page_id);
+      return INVALID_PAGE_ID;
+    }
+    uint32_t part_size = std::min(OverflowPage::CAPACITY, size - offset);
+    static_cast<OverflowPage *>(guard.GetPage())->Init(page_id, data + offset, part_size);
+    if (prev_guard.IsValid()) {
+      static_cast<OverflowPage *>(prev_guard.GetPage())->SetNextPageId(page_id);
+      LogPageImage(&prev_guard, txn);
+    } else {
+      first_page_id = page_id;
+    }
+    prev_guard = std::move(guard);
+    offset += part_size;
+  }
+  LogPageImage(&prev_guard, txn);
+  return first_page_id;
+}
+
+void TableHeap::DeleteOverflowValue(page_id_t first_page_id) {
+  auto page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    if (!guard.IsValid()) {
+      return;
+    }
+    auto next_page_id = static_cast<OverflowPage *>(guard.GetPage())->GetNextPageId();
+    guard.Drop();
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::DeleteOverflowValues(const Tuple &tuple) {
+  if (schema_ == nullptr) {
+    return;
+  }
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    DeleteOverflowValue(tuple.GetOverflowPageId(schema_, column_idx));
+  }
+}
+
+bool TableHeap::HasOverflowValues(const Tuple &tuple) {
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    if (tuple.GetOverflowPageId(schema_, column_idx) != INVALID_PAGE_ID) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TableHeap::ReadOverflowValue(TypeId type, page_id_t first_page_id, uint32_t length, Value *value) {
+  std::vector<char> data(length);
+  uint32_t offset = 0;
+  auto page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID && offset < length) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    if (!guard.IsValid()) {
+      return false;
+    }
+    auto page = static_cast<OverflowPage *>(guard.GetPage());
+    uint32_t part_size = std::min(page->GetDataSize(), length - offset);
+    memcpy(data.data() + offset, page->GetValueData(), part_size);
+    offset += part_size;
+    page_id = page->GetNextPageId();
+  }
+  *value = Value(type, data.data(), length, true);
+  return true;
+}
+
+void TableHeap::LogPageImage(WritePageGuard *guard, Transaction *txn) {
+  if (enable_logging) {
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::PAGEIMAGE, guard->PageId(),
+                         guard->GetData());
+    lsn_t lsn = log_manager_->AppendLogRecord(&log_record);
+    guard->GetPage()->SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  guard->SetDirty();
+}
+
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
-  // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Otherwise, mark the tuple as deleted.
-  page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  static_cast<TablePage *>(guard.GetPage())->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  guard.SetDirty();
+  guard.Drop();
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
   return true;
@@ -111,18 +363,28 @@ bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
 
 bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  auto page = static_cast<TablePage *>(guard.GetPage());
+  // A version with values stored out of line is only replaced through a delete, which frees its overflow pages.
+  if (schema_ != nullptr) {
+    Tuple current_tuple;
+    if (tuple.size_ > OVERFLOW_THRESHOLD ||
+        (page->GetTuple(rid, &current_tuple, txn, lock_manager_) && HasOverflowValues(current_tuple))) {
+      return false;
+    }
+  }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
-  page->WLatch();
   bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  if (is_updated) {
+    guard.SetDirty();
+  }
+  guard.Drop();
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -132,61 +394,179 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
 
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
-  page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  Tuple deleted_tuple;
+  static_cast<TablePage *>(guard.GetPage())->ApplyDelete(rid, txn, log_manager_, &deleted_tuple);
+  guard.SetDirty();
+  guard.Drop();
   lock_manager_->Unlock(txn, rid);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // The tuple is gone for good, and with it its values stored out of line.
+  DeleteOverflowValues(deleted_tuple);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
   // Rollback the delete.
-  page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  static_cast<TablePage *>(guard.GetPage())->RollbackDelete(rid, txn, log_manager_);
+  guard.SetDirty();
 }
 
 bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageRead(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
-  // Read the tuple from the page.
-  page->RLatch();
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
-  page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
-  return res;
+  // Read the tuple from the page, its values stored out of line are read from this table when accessed.
+  tuple->table_heap_ = this;
+  return static_cast<TablePage *>(guard.GetPage())->GetTuple(rid, tuple, txn, lock_manager_);
+}
+
+size_t TableHeap::Vacuum(Transaction *txn) {
+  std::unordered_map<page_id_t, FreeSpaceMap::Entry> entries;
+  {
+    std::vector<FreeSpaceMap::Entry> entry_list;
+    free_space_map_->GetEntries(&entry_list);
+    for (const auto &entry : entry_list) {
+      entries[entry.table_page_id_] = entry;
+    }
+  }
+
+  size_t num_reclaimed_bytes = 0;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the table heap.");
+    auto page = static_cast<TablePage *>(guard.GetPage());
+    auto next_page_id = page->GetNextPageId();
+    if (page->IsEmpty() && prev_page_id != INVALID_PAGE_ID && next_page_id != INVALID_PAGE_ID) {
+      guard.Drop();
+      if (ReclaimPage(prev_page_id, page_id, entries, txn)) {
+        num_reclaimed_bytes += PAGE_SIZE;
+        page_id = next_page_id;
+        continue;
+      }
+      guard = buffer_pool_manager_->FetchPageWrite(page_id);
+      BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the table heap.");
+      page = static_cast<TablePage *>(guard.GetPage());
+      next_page_id = page->GetNextPageId();
+    }
+
+    uint32_t num_gained_bytes = page->Compact();
+    if (num_gained_bytes > 0) {
+      LogPageImage(&guard, txn);
+      num_reclaimed_bytes += num_gained_bytes;
+    }
+    // Deletes leave the free space map alone, this is where the room they made becomes visible to inserts. A target
+    // page stays hidden from the other threads.
+    auto entry = entries.find(page_id);
+    if (entry != entries.end() && !IsInsertTarget(page_id)) {
+      free_space_map_->Update(entry->second, page->GetFreeSpaceRemaining());
+    }
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  return num_reclaimed_bytes;
+}
+
+bool TableHeap::ReclaimPage(page_id_t prev_page_id, page_id_t page_id,
+                            const std::unordered_map<page_id_t, FreeSpaceMap::Entry> &entries, Transaction *txn) {
+  // Wait for the inserts in flight, one of them may have found the page in the free space map.
+  std::unique_lock reclaim_latch(reclaim_latch_);
+  if (num_iterators_ > 0) {
+    return false;
+  }
+  // Latch the pages in the order of the chain, like a scan does.
+  auto prev_guard = buffer_pool_manager_->FetchPageWrite(prev_page_id);
+  auto guard = buffer_pool_manager_->FetchPageWrite(page_id);
+  if (!prev_guard.IsValid() || !guard.IsValid()) {
+    return false;
+  }
+  auto prev_page = static_cast<TablePage *>(prev_guard.GetPage());
+  auto page = static_cast<TablePage *>(guard.GetPage());
+  auto next_page_id = page->GetNextPageId();
+  if (prev_page->GetNextPageId() != page_id || !page->IsEmpty() || next_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto next_guard = buffer_pool_manager_->FetchPageWrite(next_page_id);
+  if (!next_guard.IsValid()) {
+    return false;
+  }
+  auto next_page = static_cast<TablePage *>(next_guard.GetPage());
+  prev_page->SetNextPageId(next_page_id);
+  next_page->SetPrevPageId(prev_page_id);
+  LogPageImage(&prev_guard, txn);
+  LogPageImage(&next_guard, txn);
+
+  // No insert is running, so nobody can be about to use the page through the free space map, a target, or the last
+  // page hint.
+  if (last_page_id_ == page_id) {
+    last_page_id_ = next_page_id;
+  }
+  auto entry = entries.find(page_id);
+  if (entry != entries.end()) {
+    free_space_map_->Remove(entry->second);
+  }
+  for (auto &target : insert_targets_) {
+    std::scoped_lock latch(target.latch_);
+    if (target.entry_.table_page_id_ == page_id) {
+      target.entry_ = FreeSpaceMap::Entry{};
+    }
+  }
+  // Nobody can reach the page anymore, so nobody holds it pinned.
+  guard.Drop();
+  buffer_pool_manager_->DeletePage(page_id);
+  return true;
+}
+
+bool TableHeap::IsInsertTarget(page_id_t page_id) {
+  for (auto &target : insert_targets_) {
+    std::scoped_lock latch(target.latch_);
+    if (target.entry_.table_page_id_ == page_id) {
+      return true;
+    }
+  }
+  return false;
 }
 
 TableIterator TableHeap::Begin(Transaction *txn) {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
+  // The scan reads the heap through its own buffer ring so that a large table does not flush the buffer pool.
+  auto ring = std::make_shared<BufferRing>(buffer_pool_manager_->GetPoolSize());
+  // Count the scan before walking to its first tuple, once a reclaim in flight is done, so that vacuum cannot free the
+  // empty pages being skipped or the page the scan starts on before the iterator counts itself.
+  {
+    std::shared_lock reclaim_latch(reclaim_latch_);
+    num_iterators_++;
+  }
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-    page->RLatch();
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id, ring.get());
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the table heap.");
+    auto page = static_cast<TablePage *>(guard.GetPage());
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
-    page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(page_id, false);
+    auto next_page_id = page->GetNextPageId();
+    guard.Drop();
     if (found_tuple) {
+      // The scan starts on this page, start reading the next one in the background.
+      buffer_pool_manager_->PrefetchPage(next_page_id);
       break;
     }
-    page_id = page->GetNextPageId();
+    page_id = next_page_id;
   }
-  return TableIterator(this, rid, txn);
+  TableIterator iter(this, rid, txn, std::move(ring));
+  num_iterators_--;
+  return iter;
 }
 
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
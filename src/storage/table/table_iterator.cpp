@@ -11,18 +11,40 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, std::shared_ptr<BufferRing> ring)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), ring_(std::move(ring)) {
+  table_heap_->num_iterators_++;
   if (rid.GetPageId() != INVALID_PAGE_ID) {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
 }
 
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_), ring_(other.ring_) {
+  table_heap_->num_iterators_++;
+}
+
+TableIterator::~TableIterator() {
+  table_heap_->num_iterators_--;
+  delete tuple_;
+}
+
+TableIterator &TableIterator::operator=(const TableIterator &other) {
+  other.table_heap_->num_iterators_++;
+  table_heap_->num_iterators_--;
+  table_heap_ = other.table_heap_;
+  *tuple_ = *other.tuple_;
+  txn_ = other.txn_;
+  ring_ = other.ring_;
+  return *this;
+}
+
 const Tuple &TableIterator::operator*() {
   assert(*this != table_heap_->End());
   return *tuple_;
@@ -35,19 +57,21 @@ Tuple *TableIterator::operator->() {
 
 TableIterator &TableIterator::operator++() {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  cur_page->RLatch();
-  assert(cur_page != nullptr);  // all pages are pinned
+  auto cur_guard = buffer_pool_manager->FetchPageRead(tuple_->rid_.GetPageId(), ring_.get());
+  assert(cur_guard.IsValid());  // all pages are pinned
+  auto cur_page = static_cast<TablePage *>(cur_guard.GetPage());
 
   RID next_tuple_rid;
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
+      // Latch the next page before letting go of the current one.
+      auto next_guard = buffer_pool_manager->FetchPageRead(cur_page->GetNextPageId(), ring_.get());
+      assert(next_guard.IsValid());  // all pages are pinned
+      cur_guard = std::move(next_guard);
+      cur_page = static_cast<TablePage *>(cur_guard.GetPage());
+      // Read the page after this one in the background while the scan works through this one.
+      buffer_pool_manager->PrefetchPage(cur_page->GetNextPageId());
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -55,12 +79,10 @@ TableIterator &TableIterator::operator++() {
   }
   tuple_->rid_ = next_tuple_rid;
 
+  // Copy the tuple out of the page we already hold rather than fetching and latching it a second time.
   if (*this != table_heap_->End()) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+    cur_page->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_);
   }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
   return *this;
 }
 
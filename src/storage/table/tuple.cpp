@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 
+#include "common/exception.h"
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -53,7 +55,8 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
+Tuple::Tuple(const Tuple &other)
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), table_heap_(other.table_heap_) {
   if (allocated_) {
     delete[] data_;
   }
@@ -74,6 +77,7 @@ Tuple &Tuple::operator=(const Tuple &other) {
   allocated_ = other.allocated_;
   rid_ = other.rid_;
   size_ = other.size_;
+  table_heap_ = other.table_heap_;
 
   if (allocated_) {
     // Deep copy.
@@ -92,6 +96,17 @@ Value Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const {
   assert(data_);
   const TypeId column_type = schema->GetColumn(column_idx).GetType();
   const char *data_ptr = GetDataPtr(schema, column_idx);
+  page_id_t overflow_page_id = GetOverflowPageId(schema, column_idx);
+  if (overflow_page_id != INVALID_PAGE_ID) {
+    assert(table_heap_);
+    uint32_t length = *reinterpret_cast<const uint32_t *>(data_ptr) & ~OVERFLOW_FLAG;
+    Value value(column_type);
+    if (!table_heap_->ReadOverflowValue(column_type, overflow_page_id, length, &value)) {
+      // The buffer pool has no frame to read the value into, the caller can retry once pages are unpinned.
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Couldn't fetch an overflow page.");
+    }
+    return value;
+  }
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
 }
@@ -120,6 +135,63 @@ const char *Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) c
   return (data_ + offset);
 }
 
+page_id_t Tuple::GetOverflowPageId(const Schema *schema, const uint32_t column_idx) const {
+  if (schema->GetColumn(column_idx).IsInlined()) {
+    return INVALID_PAGE_ID;
+  }
+  const char *data_ptr = GetDataPtr(schema, column_idx);
+  uint32_t length = *reinterpret_cast<const uint32_t *>(data_ptr);
+  if (length == BUSTUB_VALUE_NULL || (length & OVERFLOW_FLAG) == 0) {
+    return INVALID_PAGE_ID;
+  }
+  return *reinterpret_cast<const page_id_t *>(data_ptr + sizeof(uint32_t));
+}
+
+Tuple Tuple::MoveOutOfLine(const Schema *schema, const std::vector<page_id_t> &overflow_page_ids) const {
+  // 1. Calculate the size of the copy, the payload of a value moved out of line shrinks to a fixed size.
+  uint32_t tuple_size = schema->GetLength();
+  for (auto &i : schema->GetUnlinedColumns()) {
+    tuple_size += overflow_page_ids[i] != INVALID_PAGE_ID ? OVERFLOW_PAYLOAD_SIZE : GetPayloadSize(schema, i);
+  }
+
+  Tuple tuple;
+  tuple.allocated_ = true;
+  tuple.rid_ = rid_;
+  tuple.size_ = tuple_size;
+  tuple.data_ = new char[tuple_size];
+  tuple.table_heap_ = table_heap_;
+
+  // 2. Copy the fixed-size part, then the payloads, updating their offsets.
+  memcpy(tuple.data_, data_, schema->GetLength());
+  uint32_t offset = schema->GetLength();
+  for (auto &i : schema->GetUnlinedColumns()) {
+    const auto &col = schema->GetColumn(i);
+    *reinterpret_cast<uint32_t *>(tuple.data_ + col.GetOffset()) = offset;
+    if (overflow_page_ids[i] != INVALID_PAGE_ID) {
+      uint32_t length = *reinterpret_cast<const uint32_t *>(GetDataPtr(schema, i)) | OVERFLOW_FLAG;
+      memcpy(tuple.data_ + offset, &length, sizeof(uint32_t));
+      memcpy(tuple.data_ + offset + sizeof(uint32_t), &overflow_page_ids[i], sizeof(page_id_t));
+      offset += OVERFLOW_PAYLOAD_SIZE;
+    } else {
+      uint32_t payload_size = GetPayloadSize(schema, i);
+      memcpy(tuple.data_ + offset, GetDataPtr(schema, i), payload_size);
+      offset += payload_size;
+    }
+  }
+  return tuple;
+}
+
+uint32_t Tuple::GetPayloadSize(const Schema *schema, const uint32_t column_idx) const {
+  uint32_t length = *reinterpret_cast<const uint32_t *>(GetDataPtr(schema, column_idx));
+  if (length == BUSTUB_VALUE_NULL) {
+    return sizeof(uint32_t);
+  }
+  if ((length & OVERFLOW_FLAG) != 0) {
+    return OVERFLOW_PAYLOAD_SIZE;
+  }
+  return sizeof(uint32_t) + length;
+}
+
 std::string Tuple::ToString(const Schema *schema) const {
   std::stringstream os;
 
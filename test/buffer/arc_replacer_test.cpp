@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <vector>
+
+#include "buffer/lru_replacer.h"
+#include "../test/buffer/replacer_test_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4);
+
+  // Scenario: load pages 0-3 into frames 0-3 and access page 1 a second time, which moves it to T2.
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    arc_replacer.SetPage(frame_id, frame_id);
+    arc_replacer.Unpin(frame_id);
+  }
+  arc_replacer.Pin(1);
+  arc_replacer.Unpin(1);
+  EXPECT_EQ(4, arc_replacer.Size());
+  EXPECT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 is above its target, so its least recently used frame goes first and page 0 is remembered in B1.
+  int value;
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: reading page 0 back in hits B1, which grows the target size of T1 and puts the page in T2.
+  arc_replacer.SetPage(0, 0);
+  arc_replacer.Unpin(0);
+  EXPECT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 (frames 2 and 3) is evicted down to its target, then T2 (frames 1 and 0) is evicted from.
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: reading page 1 back in hits B2, which shrinks the target size of T1 again.
+  arc_replacer.SetPage(1, 1);
+  arc_replacer.Unpin(1);
+  EXPECT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: pinned frames are not victims.
+  arc_replacer.Pin(3);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, arc_replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(ARCReplacerTest, PrefetchTest) {
+  ARCReplacer arc_replacer(4);
+
+  // Scenario: page 0 is accessed twice, which moves it to T2. Page 1 is read ahead, then fetched once.
+  arc_replacer.SetPage(0, 0);
+  arc_replacer.Unpin(0);
+  arc_replacer.Pin(0);
+  arc_replacer.Unpin(0);
+  arc_replacer.SetPage(1, 1);
+  arc_replacer.UnpinPrefetched(1);
+  EXPECT_EQ(2, arc_replacer.Size());
+  arc_replacer.Pin(1);
+  arc_replacer.Unpin(1);
+
+  // Scenario: the read ahead is not an access, so page 1 stays in T1 and is evicted first.
+  int value;
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+}
+
+// NOLINTNEXTLINE
+TEST(ARCReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 64;
+  std::vector<page_id_t> references = MakeScanMixedWorkload(96, 64, 50, 200);
+
+  LRUReplacer lru_replacer(num_frames);
+  ARCReplacer arc_replacer(num_frames);
+  double lru_hit_ratio = ReplayHitRatio(&lru_replacer, num_frames, references);
+  double arc_hit_ratio = ReplayHitRatio(&arc_replacer, num_frames, references);
+
+  // Scanned pages are only accessed once and are evicted from T1, while the hot pages stay in T2.
+  EXPECT_GT(arc_hit_ratio, lru_hit_ratio);
+}
+
+}  // namespace bustub
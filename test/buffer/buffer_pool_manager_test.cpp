@@ -10,17 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "gtest/gtest.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
+TEST(BufferPoolManagerTest, BinaryDataTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
 
@@ -29,7 +33,7 @@ TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
   std::uniform_int_distribution<char> uniform_dist(0);
 
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(&page_id_temp);
@@ -86,12 +90,12 @@ TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
 
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(&page_id_temp);
@@ -141,4 +145,190 @@ TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+// Check that every replacement policy keeps the buffer pool consistent under eviction
+TEST(BufferPoolManagerTest, ReplacerTypeTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const int num_pages = 50;
+
+  for (ReplacerType replacer_type :
+       {ReplacerType::LRU, ReplacerType::LRU_K, ReplacerType::TWO_QUEUE, ReplacerType::ARC}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, replacer_type);
+
+    // Scenario: create more pages than fit in the pool, each tagged with its page id.
+    page_id_t page_id_temp;
+    for (int i = 0; i < num_pages; ++i) {
+      Page *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(i, page_id_temp);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: re-reading pages in a skewed order evicts and reloads them without losing any data.
+    for (int i = 0; i < 4 * num_pages; ++i) {
+      page_id_t page_id = i % 3 == 0 ? i % num_pages : i % 5;
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+
+    // Scenario: with every frame pinned, there is nothing to evict.
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      EXPECT_NE(nullptr, bpm->FetchPage(i));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(num_pages - 1));
+
+    disk_manager->ShutDown();
+    remove("test.db");
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+// Check that a page unpinned dirty while it is being flushed stays dirty until its change reaches the disk
+TEST(BufferPoolManagerTest, ConcurrentUnpinFlushTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  // Scenario: one thread keeps changing the page while another flushes it. Each round ends with the flusher racing the
+  // last unpin and then pausing, after which the page must be dirty or on the disk as it is in memory.
+  std::atomic<bool> done{false};
+  std::atomic<bool> pause{false};
+  std::atomic<bool> paused{false};
+  std::thread flusher([&] {
+    while (!done) {
+      if (pause) {
+        paused = true;
+        while (pause && !done) {
+          std::this_thread::yield();
+        }
+        paused = false;
+        continue;
+      }
+      bpm->FlushPage(page_id);
+      bpm->FlushAllPages();
+    }
+  });
+  char disk_data[PAGE_SIZE];
+  int value = 0;
+  for (int round = 0; round < 200; round++) {
+    for (int i = 0; i < 100; i++) {
+      Page *page = bpm->FetchPage(page_id);
+      EXPECT_NE(nullptr, page);
+      if (page == nullptr) {
+        break;
+      }
+      snprintf(page->GetData(), PAGE_SIZE, "value %d", value++);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    pause = true;
+    while (!paused) {
+      std::this_thread::yield();
+    }
+
+    Page *page = bpm->FetchPage(page_id);
+    EXPECT_NE(nullptr, page);
+    if (page == nullptr) {
+      break;
+    }
+    bool is_dirty = page->IsDirty();
+    disk_manager->ReadPage(page_id, disk_data);
+    EXPECT_TRUE(is_dirty || std::memcmp(disk_data, page->GetData(), PAGE_SIZE) == 0);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+    pause = false;
+    while (paused) {
+      std::this_thread::yield();
+    }
+  }
+  done = true;
+  flusher.join();
+
+  // Scenario: once flushed, the page is clean and the disk has its last value.
+  ASSERT_TRUE(bpm->FlushPage(page_id));
+  Page *page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_FALSE(page->IsDirty());
+  disk_manager->ReadPage(page_id, disk_data);
+  EXPECT_EQ(0, std::memcmp(disk_data, page->GetData(), PAGE_SIZE));
+  EXPECT_EQ("value " + std::to_string(value - 1), std::string(disk_data));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Check that no update is lost when dirty pages are evicted and read back while other threads use the pool
+TEST(BufferPoolManagerTest, ConcurrentDirtyEvictionTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_threads = 4;
+  const int pages_per_thread = 16;
+  const int num_updates = 2000;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids(num_threads * pages_per_thread);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "0");
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: every thread keeps incrementing a counter on pages of its own. The pool holds a quarter of the pages, so
+  // most fetches evict a dirty page and write it back while others read their pages in.
+  std::vector<std::vector<int>> counts(num_threads, std::vector<int>(pages_per_thread));
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      std::default_random_engine rng(tid);
+      std::uniform_int_distribution<int> dist(0, pages_per_thread - 1);
+      for (int i = 0; i < num_updates; i++) {
+        int index = dist(rng);
+        page_id_t page_id = page_ids[tid * pages_per_thread + index];
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        snprintf(page->GetData(), PAGE_SIZE, "%d", std::stoi(page->GetData()) + 1);
+        counts[tid][index]++;
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GT(bpm->GetNumSyncEvictionWrites(), 0);
+
+  for (int tid = 0; tid < num_threads; tid++) {
+    for (int index = 0; index < pages_per_thread; index++) {
+      Page *page = bpm->FetchPage(page_ids[tid * pages_per_thread + index]);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(counts[tid][index], std::stoi(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page->GetPageId(), false));
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
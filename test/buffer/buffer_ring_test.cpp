@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring_test.cpp
+//
+// Identification: test/buffer/buffer_ring_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_ring.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+const int NUM_HOT_PAGES = 16;
+const int NUM_SCAN_PAGES = 256;
+
+/** Create the hot pages [0, NUM_HOT_PAGES) and the scanned pages after them, each tagged with its page id. */
+void CreatePages(BufferPoolManager *bpm) {
+  for (int i = 0; i < NUM_HOT_PAGES + NUM_SCAN_PAGES; ++i) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+}
+
+/** Fetch and unpin a page, checking its contents. */
+void TouchPage(BufferPoolManager *bpm, page_id_t page_id, BufferRing *ring) {
+  Page *page = bpm->FetchPage(page_id, ring);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
+/**
+ * Load the hot pages, scan every other page once, then touch the hot pages again.
+ * @return the number of disk reads the second round of hot page accesses needed
+ */
+int ScanAndCountHotMisses(BufferPoolManager *bpm, DiskManager *disk_manager, BufferRing *ring) {
+  for (page_id_t page_id = 0; page_id < NUM_HOT_PAGES; ++page_id) {
+    TouchPage(bpm, page_id, nullptr);
+  }
+  // Like TableIterator, the scan fetches the next page before it unpins the current one.
+  Page *cur_page = bpm->FetchPage(NUM_HOT_PAGES, ring);
+  EXPECT_NE(nullptr, cur_page);
+  for (page_id_t page_id = NUM_HOT_PAGES + 1; page_id < NUM_HOT_PAGES + NUM_SCAN_PAGES; ++page_id) {
+    Page *next_page = bpm->FetchPage(page_id, ring);
+    EXPECT_NE(nullptr, next_page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(next_page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id - 1, false));
+  }
+  EXPECT_TRUE(bpm->UnpinPage(NUM_HOT_PAGES + NUM_SCAN_PAGES - 1, false));
+
+  int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < NUM_HOT_PAGES; ++page_id) {
+    TouchPage(bpm, page_id, nullptr);
+  }
+  return disk_manager->GetNumReads() - reads_before;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, SizingTest) {
+  // Scenario: the ring takes an eighth of the pool, at least 2 and at most SCAN_RING_SIZE frames.
+  EXPECT_EQ(2, BufferRing(10).GetCapacity());
+  EXPECT_EQ(8, BufferRing(64).GetCapacity());
+  EXPECT_EQ(SCAN_RING_SIZE, BufferRing(1 << 20).GetCapacity());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, ScanKeepsWorkingSetTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+
+  // Scenario: an ordinary scan of four times the pool size evicts every hot page.
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+    CreatePages(bpm.get());
+    EXPECT_EQ(NUM_HOT_PAGES, ScanAndCountHotMisses(bpm.get(), disk_manager.get(), nullptr));
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+  }
+
+  // Scenario: a scan through a buffer ring only recycles its own frames and the hot pages stay resident.
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+    CreatePages(bpm.get());
+    BufferRing ring(buffer_pool_size);
+    EXPECT_EQ(0, ScanAndCountHotMisses(bpm.get(), disk_manager.get(), &ring));
+    EXPECT_EQ(NUM_SCAN_PAGES, ring.GetNumPages());
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, SmallTableStaysCachedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_table_pages = buffer_pool_size / 4;
+  const int tuples_per_page = 20;
+
+  // Scenario: a scan of a table that fits in a quarter of the pool fetches each page once per tuple, like a table
+  // iterator. It never turns to the ring, however many fetches it makes.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get());
+  BufferRing ring(buffer_pool_size);
+  for (page_id_t page_id = NUM_HOT_PAGES; page_id < NUM_HOT_PAGES + num_table_pages; ++page_id) {
+    for (int i = 0; i < tuples_per_page; i++) {
+      TouchPage(bpm.get(), page_id, &ring);
+    }
+  }
+  EXPECT_EQ(num_table_pages, ring.GetNumPages());
+
+  // Scenario: the whole table is still cached for the next scan.
+  int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = NUM_HOT_PAGES; page_id < NUM_HOT_PAGES + num_table_pages; ++page_id) {
+    TouchPage(bpm.get(), page_id, nullptr);
+  }
+  EXPECT_EQ(0, disk_manager->GetNumReads() - reads_before);
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, ParallelScanKeepsWorkingSetTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 16;
+
+  // Scenario: every instance of a parallel buffer pool recycles the ring frames that hold its own pages.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get());
+  BufferRing ring(bpm->GetPoolSize());
+  EXPECT_EQ(0, ScanAndCountHotMisses(bpm.get(), disk_manager.get(), &ring));
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+}  // namespace bustub
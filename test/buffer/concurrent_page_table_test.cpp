@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table_test.cpp
+//
+// Identification: test/buffer/concurrent_page_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/concurrent_page_table.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ConcurrentPageTableTest, SampleTest) {
+  const size_t num_frames = 64;
+  ConcurrentPageTable page_table(num_frames);
+  frame_id_t frame_id;
+
+  // Scenario: an empty table has no entries.
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+
+  // Scenario: fill the table up to its number of frames and find every entry.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+    page_table.Insert(page_id * 7, page_id);
+  }
+  EXPECT_EQ(num_frames, page_table.Size());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+    ASSERT_TRUE(page_table.Find(page_id * 7, &frame_id));
+    EXPECT_EQ(page_id, frame_id);
+  }
+
+  // Scenario: overwriting an entry does not add a new one.
+  page_table.Insert(7, 42);
+  EXPECT_EQ(num_frames, page_table.Size());
+  ASSERT_TRUE(page_table.Find(7, &frame_id));
+  EXPECT_EQ(42, frame_id);
+
+  // Scenario: removing every other entry keeps the remaining entries reachable.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); page_id += 2) {
+    EXPECT_TRUE(page_table.Remove(page_id * 7));
+  }
+  EXPECT_FALSE(page_table.Remove(0));
+  EXPECT_EQ(num_frames / 2, page_table.Size());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+    EXPECT_EQ(page_id % 2 == 1, page_table.Find(page_id * 7, &frame_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ConcurrentPageTableTest, ConcurrentReadTest) {
+  const size_t num_frames = 128;
+  const int num_readers = 4;
+  ConcurrentPageTable page_table(num_frames);
+
+  // Pages [0, num_frames) stay in the table; the writer churns pages [num_frames, 2 * num_frames) around them.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+    page_table.Insert(page_id, page_id);
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < num_readers; tid++) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(2 * num_frames); ++page_id) {
+          frame_id_t frame_id;
+          // A lookup may miss an entry that is being moved, but it must never return a mismatched frame.
+          if (page_table.Find(page_id, &frame_id)) {
+            EXPECT_EQ(page_id, frame_id);
+          }
+        }
+      }
+    });
+  }
+
+  for (int round = 0; round < 200; round++) {
+    for (page_id_t page_id = num_frames; page_id < static_cast<page_id_t>(2 * num_frames); page_id += 3) {
+      page_table.Insert(page_id, page_id);
+    }
+    for (page_id_t page_id = num_frames; page_id < static_cast<page_id_t>(2 * num_frames); page_id += 3) {
+      EXPECT_TRUE(page_table.Remove(page_id));
+    }
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  frame_id_t frame_id;
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+    ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+    EXPECT_EQ(page_id, frame_id);
+  }
+  EXPECT_EQ(num_frames, page_table.Size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// fetch_pages_test.cpp
+//
+// Identification: test/buffer/fetch_pages_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Create pages [0, num_pages), each tagged with its page id. */
+void CreatePages(BufferPoolManager *bpm, int num_pages) {
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+}
+
+/** Check that every fetched page holds the requested page, and unpin it. */
+void CheckAndUnpinPages(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids,
+                        const std::vector<Page *> &pages) {
+  ASSERT_EQ(page_ids.size(), pages.size());
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    ASSERT_NE(nullptr, pages[i]);
+    EXPECT_EQ(page_ids[i], pages[i]->GetPageId());
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(FetchPagesTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get(), 20);
+
+  // Scenario: a batch mixing resident, missing and repeated pages pins each page once per occurrence, and reads
+  // every missing page once.
+  std::vector<page_id_t> page_ids{15, 3, 1, 2, 15, 7};
+  std::vector<Page *> pages;
+  int reads_before = disk_manager->GetNumReads();
+  EXPECT_EQ(6, bpm->FetchPages(page_ids, &pages));
+  EXPECT_EQ(reads_before + 4, disk_manager->GetNumReads());
+  EXPECT_EQ(pages[0], pages[4]);
+  EXPECT_EQ(2, pages[0]->GetPinCount());
+  EXPECT_EQ(1, pages[1]->GetPinCount());
+  CheckAndUnpinPages(bpm.get(), page_ids, pages);
+  EXPECT_FALSE(bpm->UnpinPage(15, false));
+
+  // Scenario: resident pages 14 and 16 are pinned first. Once every frame is pinned, the highest missing pages of the
+  // batch are not fetched.
+  page_ids = {11, 0, 4, 5, 6, 8, 9, 10, 12, 13, 14, 16};
+  EXPECT_EQ(buffer_pool_size, bpm->FetchPages(page_ids, &pages));
+  EXPECT_EQ(nullptr, pages[8]);
+  EXPECT_EQ(nullptr, pages[9]);
+  EXPECT_NE(nullptr, pages[10]);
+  EXPECT_NE(nullptr, pages[11]);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    if (pages[i] != nullptr) {
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+  }
+
+  // Scenario: an empty batch fetches nothing.
+  EXPECT_EQ(0, bpm->FetchPages({}, &pages));
+  EXPECT_TRUE(pages.empty());
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(FetchPagesTest, ConcurrentTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 2;
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 100;
+  const int num_threads = 4;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get(), num_pages);
+
+  // Scenario: overlapping batches race with each other and with single page fetches, and never deadlock.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm, tid]() {
+      std::mt19937 generator(tid);
+      std::uniform_int_distribution<page_id_t> random_page(0, num_pages - 1);
+      std::vector<page_id_t> page_ids;
+      std::vector<Page *> pages;
+      for (int round = 0; round < 200; round++) {
+        page_ids.clear();
+        for (int i = 0; i < 4; i++) {
+          page_ids.push_back(random_page(generator));
+        }
+        if (tid % 2 == 0) {
+          ASSERT_EQ(page_ids.size(), bpm->FetchPages(page_ids, &pages));
+          CheckAndUnpinPages(bpm.get(), page_ids, pages);
+        } else {
+          for (page_id_t page_id : page_ids) {
+            pages = {bpm->FetchPage(page_id)};
+            CheckAndUnpinPages(bpm.get(), {page_id}, pages);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+}  // namespace bustub
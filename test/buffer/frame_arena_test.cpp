@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, SampleTest) {
+  // Scenario: a small arena is not worth a huge page.
+  FrameArena small_arena(10);
+  EXPECT_FALSE(small_arena.UsesHugePages());
+  EXPECT_EQ(-1, small_arena.GetNumaNode());
+
+  // Scenario: the data of a large arena is aligned to a huge page, every frame's data is page-aligned and zeroed, and
+  // the book-keeping of every frame starts on its own cache line.
+  const size_t num_frames = 1000;
+  FrameArena arena(num_frames, 0);
+  EXPECT_TRUE(arena.UsesHugePages());
+  EXPECT_GE(arena.GetNumaNode(), -1);
+  EXPECT_LE(1, FrameArena::GetNumNumaNodes());
+  Page *frames = arena.GetFrames();
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frames[0].GetData()) % HUGE_PAGE_SIZE);
+  for (size_t i = 0; i < num_frames; i++) {
+    EXPECT_EQ(frames[0].GetData() + i * PAGE_SIZE, frames[i].GetData());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&frames[i]) % CACHE_LINE_SIZE);
+    EXPECT_EQ(0, frames[i].GetData()[0]);
+    EXPECT_EQ(0, frames[i].GetData()[PAGE_SIZE - 1]);
+    EXPECT_EQ(INVALID_PAGE_ID, frames[i].GetPageId());
+  }
+
+  // Scenario: a page created on its own owns its data.
+  Page page;
+  snprintf(page.GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ("Hello", std::string(page.GetData()));
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 1024;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  EXPECT_TRUE(bpm->GetArena()->UsesHugePages());
+  EXPECT_EQ(bpm->GetArena()->GetFrames(), bpm->GetPages());
+
+  // Scenario: pages written through the arena's frames survive being evicted and read back.
+  for (int i = 0; i < 2 * static_cast<int>(buffer_pool_size); i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id = 0; page_id < 2 * static_cast<int>(buffer_pool_size); page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+}
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include <vector>
+
+#include "buffer/lru_replacer.h"
+#include "../test/buffer/replacer_test_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 0);
+
+  // Scenario: access frames 1-6 once, then frames 1 and 2 a second time.
+  for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+    lru_k_replacer.Unpin(frame_id);
+  }
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames with a single access have an infinite k-distance and go first, least recently accessed first.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+
+  // Scenario: pinned frames are not victims, and pinning an evicted frame has no effect.
+  lru_k_replacer.Pin(5);
+  lru_k_replacer.Pin(3);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+
+  // Scenario: unpinning 5 records its second access, after the second accesses of 2 and 1.
+  lru_k_replacer.Unpin(5);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+
+  // Scenario: among frames with k accesses, the one whose second most recent access is oldest goes first.
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+
+  // Scenario: an evicted frame starts over with an empty history.
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 1);
+
+  // Scenario: back-to-back accesses to the same frame count as a single reference.
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Unpin(3);
+  lru_k_replacer.Unpin(2);
+
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, PrefetchTest) {
+  LRUKReplacer lru_k_replacer(4, 2, 0);
+
+  // Scenario: frame 0 is accessed twice. Frame 1 is read ahead, then fetched once.
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.UnpinPrefetched(1);
+  EXPECT_EQ(2, lru_k_replacer.Size());
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+
+  // Scenario: the read ahead is not an access, so frame 1 has a single access and is evicted first.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, SetPageTest) {
+  LRUKReplacer lru_k_replacer(4, 2, 0);
+
+  // Scenario: frames 0 and 1 are accessed twice. Frame 0 is then reused for another page without being victimized,
+  // as the buffer pool does for a deleted page or a recycled ring frame.
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.SetPage(0, 5);
+  lru_k_replacer.Unpin(0);
+
+  // Scenario: the new page starts with a single access, so frame 0 goes first.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 64;
+  std::vector<page_id_t> references = MakeScanMixedWorkload(96, 64, 50, 200);
+
+  LRUReplacer lru_replacer(num_frames);
+  LRUKReplacer lru_k_replacer(num_frames);
+  double lru_hit_ratio = ReplayHitRatio(&lru_replacer, num_frames, references);
+  double lru_k_hit_ratio = ReplayHitRatio(&lru_k_replacer, num_frames, references);
+
+  // Every scan flushes the hot pages out of an LRU pool, while LRU-K evicts the scanned pages first.
+  EXPECT_GT(lru_k_hit_ratio, lru_hit_ratio);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, TupleScanResistanceTest) {
+  const size_t num_frames = 64;
+  std::vector<page_id_t> references = MakeScanMixedWorkload(96, 64, 50, 200, 20);
+
+  // Scenario: a scan fetches and unpins a page once per tuple. Those references are correlated, so the scanned pages
+  // keep a single access each and are still evicted before the hot pages.
+  LRUReplacer lru_replacer(num_frames);
+  LRUKReplacer lru_k_replacer(num_frames);
+  double lru_hit_ratio = ReplayHitRatio(&lru_replacer, num_frames, references);
+  double lru_k_hit_ratio = ReplayHitRatio(&lru_k_replacer, num_frames, references);
+  EXPECT_GT(lru_k_hit_ratio, lru_hit_ratio);
+
+  // Scenario: without a correlated reference period every scanned page looks hot as soon as it is read, and pushes the
+  // hot pages out.
+  LRUKReplacer uncorrelated_replacer(num_frames, LRUK_REPLACER_K, 0);
+  double uncorrelated_hit_ratio = ReplayHitRatio(&uncorrelated_replacer, num_frames, references);
+  EXPECT_GT(lru_k_hit_ratio, uncorrelated_hit_ratio);
+}
+
+}  // namespace bustub
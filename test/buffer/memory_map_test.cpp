@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_map_test.cpp
+//
+// Identification: test/buffer/memory_map_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+class MemoryMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  static void RemoveFiles() {
+    remove("test.db");
+    remove("test.log");
+    remove("test.fsm");
+    remove("test.crc");
+    remove("test.map");
+  }
+
+  /** Create pages [0, num_pages) in the database file, each tagged with its page id. */
+  static void CreatePages(int num_pages) {
+    DiskManager disk_manager("test.db");
+    BufferPoolManagerInstance bpm(num_pages, &disk_manager);
+    for (int i = 0; i < num_pages; ++i) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(MemoryMapTest, FetchTest) {
+  CreatePages(20);
+  DiskManager disk_manager("test.db");
+  ASSERT_TRUE(disk_manager.MapDataFiles());
+  EXPECT_TRUE(disk_manager.IsMapped());
+  BufferPoolManagerInstance bpm(5, &disk_manager);
+
+  // Scenario: a fetched page is the page in the mapping, it is not copied into the frame.
+  Page *page = bpm.FetchPage(3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(disk_manager.ReadMappedPage(3), page->GetData());
+  EXPECT_EQ("page 3", std::string(page->GetData()));
+  EXPECT_EQ(1, page->GetPinCount());
+  EXPECT_TRUE(bpm.UnpinPage(3, false));
+
+  // Scenario: batches and read-ahead map their frames too, and every frame can be evicted and reused.
+  std::vector<page_id_t> page_ids{7, 8, 9, 12};
+  std::vector<Page *> pages;
+  ASSERT_EQ(4, bpm.FetchPages(page_ids, &pages));
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    EXPECT_EQ(disk_manager.ReadMappedPage(page_ids[i]), pages[i]->GetData());
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+    EXPECT_TRUE(bpm.UnpinPage(page_ids[i], false));
+  }
+  for (page_id_t page_id = 0; page_id < 20; page_id++) {
+    page = bpm.FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+  }
+
+  // Scenario: a new page lies past the mapping, it gets a frame of its own and is read back through a copy.
+  page_id_t page_id;
+  page = bpm.NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(20, page_id);
+  EXPECT_EQ(nullptr, disk_manager.ReadMappedPage(page_id));
+  snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+  EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+  for (page_id_t other = 0; other < 5; other++) {
+    ASSERT_NE(nullptr, bpm.FetchPage(other));
+    EXPECT_TRUE(bpm.UnpinPage(other, false));
+  }
+  page = bpm.FetchPage(20);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 20", std::string(page->GetData()));
+  EXPECT_TRUE(bpm.UnpinPage(20, false));
+  EXPECT_EQ(0, disk_manager.GetNumCorruptPages());
+}
+
+// NOLINTNEXTLINE
+TEST_F(MemoryMapTest, ModeTest) {
+  CreatePages(4);
+
+  // Scenario: a read-only instance serves its pages from the mapping.
+  {
+    BustubInstance instance("test.db", true);
+    EXPECT_TRUE(instance.disk_manager_->IsMapped());
+    Page *page = instance.buffer_pool_manager_->FetchPage(2);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(instance.disk_manager_->ReadMappedPage(2), page->GetData());
+    instance.buffer_pool_manager_->UnpinPage(2, false);
+  }
+  {
+    BustubInstance instance("test.db");
+    EXPECT_FALSE(instance.disk_manager_->IsMapped());
+  }
+
+  // Scenario: compressed data files cannot be mapped.
+  RemoveFiles();
+  DiskManager disk_manager({"test.db"}, 0, DiskBackendType::STREAM, true);
+  EXPECT_FALSE(disk_manager.MapDataFiles());
+  EXPECT_FALSE(disk_manager.IsMapped());
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(MemoryMapTest, WriteTest) {
+  CreatePages(4);
+  {
+    BustubInstance instance("test.db", true);
+    BufferPoolManager *bpm = instance.buffer_pool_manager_;
+    const char *mapped = instance.disk_manager_->ReadMappedPage(2);
+    ASSERT_NE(nullptr, mapped);
+
+    // Scenario: write-latching a mapped page copies it out of the read-only mapping, and the copy is written back.
+    {
+      auto guard = bpm->FetchPageWrite(2);
+      ASSERT_TRUE(guard.IsValid());
+      EXPECT_NE(mapped, guard.GetData());
+      EXPECT_EQ("page 2", std::string(guard.GetData()));
+      snprintf(guard.GetData(), PAGE_SIZE, "changed 2");
+      guard.SetDirty();
+    }
+    Page *page = bpm->FetchPage(2);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("changed 2", std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(2, false));
+    EXPECT_TRUE(bpm->FlushPage(2));
+    EXPECT_EQ("changed 2", std::string(mapped));
+
+    // Scenario: so does the write latch of a page fetched without a guard.
+    page = bpm->FetchPage(3);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(instance.disk_manager_->ReadMappedPage(3), page->GetData());
+    page->WLatch();
+    snprintf(page->GetData(), PAGE_SIZE, "changed 3");
+    page->WUnlatch();
+    EXPECT_TRUE(bpm->UnpinPage(3, true));
+    EXPECT_EQ("page 3", std::string(instance.disk_manager_->ReadMappedPage(3)));
+    bpm->FlushAllPages();
+  }
+
+  // Scenario: the changes are in the database file.
+  DiskManager disk_manager("test.db");
+  char data[PAGE_SIZE];
+  disk_manager.ReadPage(2, data);
+  EXPECT_EQ("changed 2", std::string(data));
+  disk_manager.ReadPage(3, data);
+  EXPECT_EQ("changed 3", std::string(data));
+  disk_manager.ShutDown();
+}
+
+}  // namespace bustub
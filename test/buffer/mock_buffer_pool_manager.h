@@ -16,18 +16,18 @@
 #include <unordered_map>
 
 #include "../test/buffer/counter.h"
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 
 namespace bustub {
 
 // Add callback functions on BufferPoolManager
-class MockBufferPoolManager : public BufferPoolManager {
+class MockBufferPoolManager : public BufferPoolManagerInstance {
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (MockBufferPoolManager::*)(enum CallbackType type, FuncType func_type);
 
   MockBufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr)
-      : BufferPoolManager(pool_size, disk_manager, log_manager) {}
+      : BufferPoolManagerInstance(pool_size, disk_manager, log_manager) {}
 
   void counter_callback(enum CallbackType type, FuncType func_type) {
     if (type == CallbackType::BEFORE) {
@@ -124,9 +124,9 @@ class MockBufferPoolManager : public BufferPoolManager {
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id) {
+  Page *FetchPageImpl(page_id_t page_id) override {
     counter.AddCount(FuncType::FetchPage);
-    return BufferPoolManager::FetchPageImpl(page_id);
+    return BufferPoolManagerInstance::FetchPageImpl(page_id);
   }
 
   /**
@@ -135,9 +135,9 @@ class MockBufferPoolManager : public BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override {
     counter.AddCount(FuncType::UnpinPage);
-    return BufferPoolManager::UnpinPageImpl(page_id, is_dirty);
+    return BufferPoolManagerInstance::UnpinPageImpl(page_id, is_dirty);
   }
 
   /**
@@ -145,9 +145,9 @@ class MockBufferPoolManager : public BufferPoolManager {
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id) {
+  bool FlushPageImpl(page_id_t page_id) override {
     counter.AddCount(FuncType::FlushPage);
-    return BufferPoolManager::FlushPageImpl(page_id);
+    return BufferPoolManagerInstance::FlushPageImpl(page_id);
   }
 
   /**
@@ -155,9 +155,9 @@ class MockBufferPoolManager : public BufferPoolManager {
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id) {
+  Page *NewPageImpl(page_id_t *page_id) override {
     counter.AddCount(FuncType::NewPage);
-    return BufferPoolManager::NewPageImpl(page_id);
+    return BufferPoolManagerInstance::NewPageImpl(page_id);
   }
 
   /**
@@ -165,17 +165,17 @@ class MockBufferPoolManager : public BufferPoolManager {
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id) {
+  bool DeletePageImpl(page_id_t page_id) override {
     counter.AddCount(FuncType::DeletePage);
-    return BufferPoolManager::DeletePageImpl(page_id);
+    return BufferPoolManagerInstance::DeletePageImpl(page_id);
   }
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl() {
+  void FlushAllPagesImpl() override {
     counter.AddCount(FuncType::FlushAllPages);
-    BufferPoolManager::FlushAllPagesImpl();
+    BufferPoolManagerInstance::FlushAllPagesImpl();
   }
 
   // For grading. Do not modify!
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner_test.cpp
+//
+// Identification: test/buffer/page_cleaner_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Pages are tagged after their header, so that the tag does not overwrite the page LSN. */
+constexpr size_t TAG_OFFSET = sizeof(page_id_t) + sizeof(lsn_t);
+constexpr size_t TAG_SIZE = 32;
+
+/** Create pages [first, first + num_pages), each tagged with its page id and left dirty. */
+void CreatePages(BufferPoolManager *bpm, int first, int num_pages) {
+  for (int i = first; i < first + num_pages; ++i) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    snprintf(page->GetData() + TAG_OFFSET, TAG_SIZE, "page %d", i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+}
+
+/** Fetch and unpin a page, checking its contents. */
+void CheckPage(BufferPoolManager *bpm, page_id_t page_id) {
+  Page *page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData() + TAG_OFFSET));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
+/** Wait up to a second for a condition to hold. */
+bool WaitFor(const std::function<bool()> &condition) {
+  for (int i = 0; i < 1000 && !condition(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return condition();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+
+  // Scenario: without a cleaner, every dirty victim is written back by the eviction.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get(), 0, 10);
+  CreatePages(bpm.get(), 10, 5);
+  EXPECT_EQ(5, bpm->GetNumSyncEvictionWrites());
+  EXPECT_EQ(0, bpm->GetNumCleanerWrites());
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+
+  // Scenario: once no frame is free, the cleaner writes back the next half of the pool to be evicted.
+  disk_manager = std::make_unique<DiskManager>(db_name);
+  bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  bpm->RunPageCleaner(50, 50);
+  CreatePages(bpm.get(), 0, 10);
+  ASSERT_TRUE(WaitFor([&bpm] { return bpm->GetNumCleanerWrites() >= 5; }));
+
+  // Scenario: the evictions then find clean victims.
+  CreatePages(bpm.get(), 10, 5);
+  EXPECT_EQ(0, bpm->GetNumSyncEvictionWrites());
+
+  // Scenario: the pages the cleaner wrote back can be read again.
+  bpm->StopPageCleaner();
+  for (page_id_t page_id = 0; page_id < 15; ++page_id) {
+    CheckPage(bpm.get(), page_id);
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, WriteAheadLogTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get(), log_manager.get());
+  enable_logging = true;
+  log_manager->SetPersistentLSN(5);
+
+  // Scenario: pages whose last change is not in the persistent log are not written back.
+  for (int i = 0; i < 4; ++i) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    page->SetLSN(i < 2 ? 10 : 5);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->RunPageCleaner(100, 100);
+  ASSERT_TRUE(WaitFor([&bpm] { return bpm->GetNumCleanerWrites() >= 2; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5 * PAGE_CLEANER_INTERVAL));
+  EXPECT_EQ(2, bpm->GetNumCleanerWrites());
+
+  // Scenario: they are written back once the log has been flushed past them.
+  log_manager->SetPersistentLSN(10);
+  EXPECT_TRUE(WaitFor([&bpm] { return bpm->GetNumCleanerWrites() == 4; }));
+
+  enable_logging = false;
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, ConcurrentTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 2;
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 100;
+  const int num_threads = 4;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+  bpm->RunPageCleaner(25, 50);
+  CreatePages(bpm.get(), 0, num_pages);
+
+  // Scenario: the cleaners race with threads that rewrite and dirty random pages, and no write is lost.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm, tid]() {
+      std::mt19937 generator(tid);
+      std::uniform_int_distribution<page_id_t> random_page(0, num_pages - 1);
+      for (int i = 0; i < 1000; i++) {
+        page_id_t page_id = random_page(generator);
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        page->WLatch();
+        snprintf(page->GetData() + TAG_OFFSET, TAG_SIZE, "page %d", page_id);
+        page->WUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(WaitFor([&bpm] { return bpm->GetNumCleanerWrites() > 0; }));
+
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    CheckPage(bpm.get(), page_id);
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+}  // namespace bustub
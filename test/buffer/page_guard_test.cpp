@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard_test.cpp
+//
+// Identification: test/buffer/page_guard_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+
+  // Scenario: a guard unpins its page when it goes out of scope, and a new page is unpinned as dirty.
+  page_id_t page_id;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_EQ(page_id, guard.PageId());
+    EXPECT_EQ(1, guard.GetPage()->GetPinCount());
+    snprintf(guard.GetData(), PAGE_SIZE, "Hello");
+  }
+  Page *page = bpm->FetchPage(page_id);
+  EXPECT_EQ(1, page->GetPinCount());
+  EXPECT_TRUE(page->IsDirty());
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_TRUE(bpm->FlushPage(page_id));
+
+  // Scenario: moving a guard hands over its pin; only the last owner unpins the page.
+  {
+    auto guard = bpm->FetchPageBasic(page_id);
+    BasicPageGuard other(std::move(guard));
+    EXPECT_FALSE(guard.IsValid());  // NOLINT
+    EXPECT_EQ(1, other.GetPage()->GetPinCount());
+    guard = std::move(other);
+    EXPECT_EQ(1, guard.GetPage()->GetPinCount());
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_FALSE(page->IsDirty());
+
+  // Scenario: read guards share the page; a write guard that modified the page unpins it as dirty.
+  {
+    auto first = bpm->FetchPageRead(page_id);
+    auto second = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(2, first.GetPage()->GetPinCount());
+    EXPECT_EQ("Hello", std::string(second.GetData()));
+  }
+  {
+    auto guard = bpm->FetchPageWrite(page_id);
+    snprintf(guard.GetData(), PAGE_SIZE, "World");
+    guard.SetDirty();
+    guard.Drop();
+    EXPECT_FALSE(guard.IsValid());
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_TRUE(page->IsDirty());
+
+  // Scenario: the write latch is released with the guard, so the page can be latched again.
+  {
+    auto guard = bpm->FetchPageBasic(page_id).UpgradeWrite();
+    EXPECT_EQ(1, guard.GetPage()->GetPinCount());
+    EXPECT_EQ("World", std::string(guard.GetData()));
+  }
+  { auto guard = bpm->FetchPageRead(page_id); }
+  EXPECT_EQ(0, page->GetPinCount());
+
+  // Scenario: guards never leak pins, so the whole pool stays usable.
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    page_id_t new_page_id;
+    auto guard = bpm->NewPageGuarded(&new_page_id).UpgradeWrite();
+    ASSERT_TRUE(guard.IsValid());
+  }
+
+  // Scenario: a fetch that fails returns a guard that does not hold a page.
+  std::vector<BasicPageGuard> guards;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t new_page_id;
+    guards.push_back(bpm->NewPageGuarded(&new_page_id));
+  }
+  EXPECT_FALSE(bpm->FetchPageRead(page_id).IsValid());
+  guards.clear();
+  EXPECT_TRUE(bpm->FetchPageRead(page_id).IsValid());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, ParallelTest) {
+  const std::string db_name = "test.db";
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 2, disk_manager.get());
+
+  // Scenario: guards unpin pages through the buffer pool they were fetched from, which routes them to the instance.
+  for (int i = 0; i < 10; i++) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id).UpgradeWrite();
+    ASSERT_TRUE(guard.IsValid());
+    snprintf(guard.GetData(), PAGE_SIZE, "page %d", page_id);
+  }
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    auto guard = bpm->FetchPageRead(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(guard.GetData()));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+}
+
+}  // namespace bustub
@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up every instance, and new pages are handed out
+  // round robin so every instance gets its share of the pool.
+  std::vector<page_id_t> page_ids{page_id_temp};
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.push_back(page_id_temp);
+  }
+  for (size_t i = 0; i < num_instances; ++i) {
+    auto owned =
+        std::count_if(page_ids.begin(), page_ids.end(), [&](page_id_t id) { return id % num_instances == i; });
+    EXPECT_EQ(buffer_pool_size, static_cast<size_t>(owned));
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning page 0, a new page can only be created in the instance that owns page 0.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp % num_instances);
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+
+  // Scenario: We should be able to fetch the data we wrote a while ago once a frame is available again.
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: Pinned pages cannot be deleted, unpinned pages can.
+  EXPECT_EQ(false, bpm->DeletePage(page_ids[1]));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[1], false));
+  EXPECT_EQ(true, bpm->DeletePage(page_ids[1]));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const std::string db_name = "test.db";
+  const size_t num_threads = 8;
+  const size_t pages_per_thread = 32;
+  const size_t num_fetches = 5000;
+
+  // The same workload is run with a single instance and with one instance per thread. Every run checks that
+  // concurrent readers always see the contents written by the creator of the page.
+  for (size_t num_instances : {size_t{1}, size_t{2}, num_threads}) {
+    auto *disk_manager = new DiskManager(db_name);
+    // The pool is smaller than the working set so that misses and evictions happen concurrently with hits.
+    auto *bpm = new ParallelBufferPoolManager(num_instances, num_threads * pages_per_thread / 2 / num_instances,
+                                              disk_manager);
+
+    std::vector<std::vector<page_id_t>> thread_pages(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&, tid]() {
+        std::vector<page_id_t> &pages = thread_pages[tid];
+        while (pages.size() < pages_per_thread) {
+          page_id_t page_id;
+          Page *page = bpm->NewPage(&page_id);
+          if (page == nullptr) {
+            continue;
+          }
+          snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+          EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+          pages.push_back(page_id);
+        }
+
+        std::default_random_engine rng(tid);
+        std::uniform_int_distribution<size_t> dist(0, pages_per_thread - 1);
+        for (size_t i = 0; i < num_fetches; i++) {
+          page_id_t page_id = pages[dist(rng)];
+          Page *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            continue;
+          }
+          page->RLatch();
+          EXPECT_EQ(page_id, std::stoi(page->GetData()));
+          page->RUnlatch();
+          EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    // Some fetches missed and read their page back.
+    EXPECT_GT(disk_manager->GetNumReads(), 0);
+
+    // Every page survives being evicted and read back.
+    for (const auto &pages : thread_pages) {
+      for (page_id_t page_id : pages) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(page_id, std::stoi(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, DISABLED_ContentionBenchmarkTest) {
+  // Threads fetch random pages of their own from a pool half the size of the working set, so that most fetches miss
+  // and take the latch of the instance the page belongs to. Compare the throughput of one latch with that of several.
+  const std::string db_name = "test.db";
+  const size_t num_threads = 8;
+  const size_t pages_per_thread = 256;
+  const size_t num_fetches = 50000;
+
+  for (size_t num_instances : {size_t{1}, size_t{2}, size_t{4}, num_threads}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new ParallelBufferPoolManager(num_instances, num_threads * pages_per_thread / 2 / num_instances,
+                                              disk_manager);
+    std::vector<std::vector<page_id_t>> thread_pages(num_threads);
+    for (auto &pages : thread_pages) {
+      while (pages.size() < pages_per_thread) {
+        page_id_t page_id;
+        ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+        ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+        pages.push_back(page_id);
+      }
+    }
+    bpm->FlushAllPages();
+    int num_reads = disk_manager->GetNumReads();
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&, tid]() {
+        std::default_random_engine rng(tid);
+        std::uniform_int_distribution<size_t> dist(0, pages_per_thread - 1);
+        for (size_t i = 0; i < num_fetches; i++) {
+          page_id_t page_id = thread_pages[tid][dist(rng)];
+          if (bpm->FetchPage(page_id) != nullptr) {
+            bpm->UnpinPage(page_id, false);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << num_instances << " instance(s): " << static_cast<size_t>(num_threads * num_fetches / elapsed)
+              << " fetches/s, " << disk_manager->GetNumReads() - num_reads << " misses" << std::endl;
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+}  // namespace bustub
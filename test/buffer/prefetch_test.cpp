@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefetch_test.cpp
+//
+// Identification: test/buffer/prefetch_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Create pages [0, num_pages), each tagged with its page id. */
+void CreatePages(BufferPoolManager *bpm, int num_pages) {
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+}
+
+/** Fetch and unpin a page, checking its contents. */
+void CheckPage(BufferPoolManager *bpm, page_id_t page_id) {
+  Page *page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(PrefetchTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const int num_pages = 50;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get(), num_pages);
+
+  // Scenario: resident pages and invalid page ids are not read ahead.
+  EXPECT_FALSE(bpm->PrefetchPage(num_pages - 1));
+  EXPECT_FALSE(bpm->PrefetchPage(INVALID_PAGE_ID));
+
+  // Scenario: pages that were evicted are read back in the background.
+  for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+    EXPECT_TRUE(bpm->PrefetchPage(page_id));
+  }
+  for (int i = 0; i < 1000 && bpm->GetNumPrefetchedPages() < 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(5, bpm->GetNumPrefetchedPages());
+
+  // Scenario: fetching the prefetched pages does not touch the disk.
+  int reads_before = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+    CheckPage(bpm.get(), page_id);
+  }
+  EXPECT_EQ(reads_before, disk_manager->GetNumReads());
+
+  // Scenario: prefetched pages are not pinned, so they can be evicted and deleted like any other page.
+  EXPECT_TRUE(bpm->DeletePage(0));
+  for (page_id_t page_id = 1; page_id < num_pages; ++page_id) {
+    CheckPage(bpm.get(), page_id);
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(PrefetchTest, ConcurrentScanTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 2;
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 200;
+  const int num_threads = 4;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+  CreatePages(bpm.get(), num_pages);
+
+  // Scenario: scans that read ahead of themselves race with each other, with their own read-ahead and with random
+  // lookups, and every fetch still sees the right page.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm, tid]() {
+      std::mt19937 generator(tid);
+      std::uniform_int_distribution<page_id_t> random_page(0, num_pages - 1);
+      for (int round = 0; round < 3; round++) {
+        for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+          bpm->PrefetchPage(page_id + 2);
+          CheckPage(bpm.get(), tid % 2 == 0 ? page_id : random_page(generator));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+}
+
+}  // namespace bustub
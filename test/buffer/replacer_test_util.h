@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_test_util.h
+//
+// Identification: test/buffer/replacer_test_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * Replay a page reference string against a replacer the way the buffer pool drives it: a hit pins and unpins the
+ * frame holding the page, a miss takes a free frame or a victim and reports the new page before unpinning it.
+ * @return the fraction of references that hit
+ */
+inline double ReplayHitRatio(Replacer *replacer, size_t num_frames, const std::vector<page_id_t> &references) {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(num_frames, INVALID_PAGE_ID);
+  size_t next_free_frame = 0;
+  size_t hits = 0;
+  for (page_id_t page_id : references) {
+    frame_id_t frame_id;
+    auto iter = page_table.find(page_id);
+    if (iter != page_table.end()) {
+      hits++;
+      frame_id = iter->second;
+      replacer->Pin(frame_id);
+    } else {
+      if (next_free_frame < num_frames) {
+        frame_id = static_cast<frame_id_t>(next_free_frame++);
+      } else {
+        EXPECT_TRUE(replacer->Victim(&frame_id));
+        page_table.erase(frame_pages[frame_id]);
+      }
+      page_table[page_id] = frame_id;
+      frame_pages[frame_id] = page_id;
+      replacer->SetPage(frame_id, page_id);
+    }
+    replacer->Unpin(frame_id);
+  }
+  return static_cast<double>(hits) / static_cast<double>(references.size());
+}
+
+/**
+ * Build a reference string of rounds of random point lookups on a hot set of pages, each followed by a sequential scan
+ * of pages that are never referenced again. A scan references each page once per tuple it reads from the page, like
+ * a table iterator does.
+ */
+inline std::vector<page_id_t> MakeScanMixedWorkload(page_id_t num_hot_pages, page_id_t scan_length, int num_rounds,
+                                                    int lookups_per_round, int tuples_per_page = 1) {
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<page_id_t> hot_page(0, num_hot_pages - 1);
+  std::vector<page_id_t> references;
+  page_id_t next_cold_page = num_hot_pages;
+  for (int round = 0; round < num_rounds; round++) {
+    for (int i = 0; i < lookups_per_round; i++) {
+      references.push_back(hot_page(generator));
+    }
+    for (page_id_t i = 0; i < scan_length; i++) {
+      references.insert(references.end(), tuples_per_page, next_cold_page++);
+    }
+  }
+  return references;
+}
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <vector>
+
+#include "buffer/lru_replacer.h"
+#include "../test/buffer/replacer_test_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, SampleTest) {
+  TwoQueueReplacer two_queue_replacer(8, 2, 2);
+
+  // Scenario: load pages 10-13 into frames 0-3, they all start out in A1in.
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    two_queue_replacer.SetPage(frame_id, 10 + frame_id);
+    two_queue_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(4, two_queue_replacer.Size());
+
+  // Scenario: A1in is a FIFO, accessing frame 0 again does not save it.
+  two_queue_replacer.Pin(0);
+  two_queue_replacer.Unpin(0);
+  int value;
+  ASSERT_TRUE(two_queue_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(two_queue_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  // A1in is within its share now, but Am has nothing to evict.
+  ASSERT_TRUE(two_queue_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: A1out remembers pages 11 and 12. Page 11 comes back into Am, page 10 was forgotten and enters A1in.
+  two_queue_replacer.SetPage(0, 11);
+  two_queue_replacer.Unpin(0);
+  two_queue_replacer.SetPage(1, 10);
+  two_queue_replacer.Unpin(1);
+  EXPECT_EQ(3, two_queue_replacer.Size());
+
+  // Scenario: with A1in within its share, Am is evicted from first.
+  ASSERT_TRUE(two_queue_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(two_queue_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+
+  // Scenario: pinned frames are not victims.
+  two_queue_replacer.Pin(1);
+  EXPECT_FALSE(two_queue_replacer.Victim(&value));
+  two_queue_replacer.Unpin(1);
+  ASSERT_TRUE(two_queue_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(0, two_queue_replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 64;
+  std::vector<page_id_t> references = MakeScanMixedWorkload(96, 64, 50, 200);
+
+  LRUReplacer lru_replacer(num_frames);
+  TwoQueueReplacer two_queue_replacer(num_frames);
+  double lru_hit_ratio = ReplayHitRatio(&lru_replacer, num_frames, references);
+  double two_queue_hit_ratio = ReplayHitRatio(&two_queue_replacer, num_frames, references);
+
+  // Scanned pages never make it out of A1in, while hot pages re-read from A1out stay resident in Am.
+  EXPECT_GT(two_queue_hit_ratio, lru_hit_ratio);
+}
+
+}  // namespace bustub
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_file_test.cpp
+//
+// Identification: test/storage/compressed_page_file_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/util/compression_util.h"
+#include "gtest/gtest.h"
+#include "storage/disk/compressed_page_file.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class CompressedPageFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  static void RemoveFiles() {
+    remove("test.db");
+    remove("test.log");
+    remove("test.fsm");
+    remove("test.crc");
+    remove("test.map");
+  }
+
+  /** A page of rows of small integers and short strings, like the tables of the table generator. */
+  static std::vector<char> MakeTablePage(int seed) {
+    std::vector<char> page(PAGE_SIZE, 0);
+    std::mt19937 generator(seed);
+    for (size_t offset = 0; offset + 16 <= PAGE_SIZE; offset += 16) {
+      int32_t key = static_cast<int32_t>(offset / 16) + seed * 1000;
+      int32_t value = static_cast<int32_t>(generator() % 10);
+      memcpy(page.data() + offset, &key, sizeof(key));
+      memcpy(page.data() + offset + 4, &value, sizeof(value));
+      snprintf(page.data() + offset + 8, 8, "name%d", value);
+    }
+    return page;
+  }
+
+  static std::vector<char> MakeRandomPage(int seed) {
+    std::vector<char> page(PAGE_SIZE);
+    std::mt19937 generator(seed);
+    for (auto &byte : page) {
+      byte = static_cast<char>(generator());
+    }
+    return page;
+  }
+
+  static size_t GetFileSize(const std::string &file_name) {
+    struct stat stat_buf;
+    return stat(file_name.c_str(), &stat_buf) == 0 ? stat_buf.st_size : 0;
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(CompressedPageFileTest, CodecTest) {
+  std::vector<std::vector<char>> inputs{MakeTablePage(1), MakeRandomPage(2), std::vector<char>(PAGE_SIZE, 0),
+                                        std::vector<char>(7, 'a'), std::vector<char>(300, 'b')};
+  for (const auto &input : inputs) {
+    std::vector<char> compressed(2 * input.size() + 16);
+    size_t size = CompressionUtil::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+    ASSERT_GT(size, 0);
+    std::vector<char> output(input.size());
+    ASSERT_TRUE(CompressionUtil::Decompress(compressed.data(), size, output.data(), output.size()));
+    EXPECT_EQ(input, output);
+    // Truncated data does not decompress.
+    EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), size - 1, output.data(), output.size()));
+  }
+
+  // Scenario: table data compresses well, random data does not fit in less than its size.
+  std::vector<char> compressed(PAGE_SIZE);
+  EXPECT_LT(CompressionUtil::Compress(inputs[0].data(), PAGE_SIZE, compressed.data(), PAGE_SIZE), PAGE_SIZE / 2);
+  EXPECT_EQ(0, CompressionUtil::Compress(inputs[1].data(), PAGE_SIZE, compressed.data(), PAGE_SIZE - 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedPageFileTest, SlotTest) {
+  int fd = open("test.db", O_RDWR | O_CREAT, 0644);
+  ASSERT_GE(fd, 0);
+  std::vector<char> buf(PAGE_SIZE);
+  {
+    CompressedPageFile file(fd, "test.map", true);
+    // Scenario: a page that was never written reads as zeros.
+    buf[0] = 1;
+    ASSERT_TRUE(file.ReadPage(3, buf.data()));
+    EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), buf);
+
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      ASSERT_TRUE(file.WritePage(page_id, MakeTablePage(page_id).data()));
+    }
+    size_t num_slots = file.GetNumSlots();
+    EXPECT_LT(num_slots, 4 * CompressedPageFile::SLOTS_PER_PAGE / 2);
+
+    // Scenario: a page that no longer compresses moves to the end of the file, and its run is reused.
+    ASSERT_TRUE(file.WritePage(1, MakeRandomPage(1).data()));
+    EXPECT_EQ(num_slots + CompressedPageFile::SLOTS_PER_PAGE, file.GetNumSlots());
+    ASSERT_TRUE(file.WritePage(5, MakeTablePage(1).data()));
+    EXPECT_EQ(num_slots + CompressedPageFile::SLOTS_PER_PAGE, file.GetNumSlots());
+
+    std::vector<std::vector<char>> pages(6, std::vector<char>(PAGE_SIZE));
+    ASSERT_TRUE(file.ReadPages(0, {pages[0].data(), pages[1].data(), pages[2].data(), pages[3].data(),
+                                   pages[4].data(), pages[5].data()}));
+    EXPECT_EQ(MakeTablePage(0), pages[0]);
+    EXPECT_EQ(MakeRandomPage(1), pages[1]);
+    EXPECT_EQ(MakeTablePage(3), pages[3]);
+    EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), pages[4]);
+    EXPECT_EQ(MakeTablePage(1), pages[5]);
+    file.Close();
+  }
+
+  // Scenario: the slot map is kept in the slot map file, and the free slots are found again.
+  CompressedPageFile reopened(fd, "test.map", false);
+  EXPECT_EQ(6, reopened.GetNumPages());
+  ASSERT_TRUE(reopened.ReadPage(1, buf.data()));
+  EXPECT_EQ(MakeRandomPage(1), buf);
+  size_t num_slots = reopened.GetNumSlots();
+  ASSERT_TRUE(reopened.WritePage(1, MakeTablePage(1).data()));
+  ASSERT_TRUE(reopened.WritePage(6, MakeTablePage(6).data()));
+  EXPECT_EQ(num_slots, reopened.GetNumSlots());
+  reopened.Close();
+  close(fd);
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedPageFileTest, DiskManagerTest) {
+  const page_id_t num_pages = 2 * EXTENT_SIZE;
+  std::vector<std::vector<char>> pages;
+  std::vector<std::pair<page_id_t, const char *>> writes;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    pages.push_back(MakeTablePage(page_id));
+    writes.emplace_back(page_id, pages.back().data());
+  }
+  {
+    auto dm = DiskManager({"test.db"}, 0, DiskBackendType::POSIX, true);
+    EXPECT_TRUE(dm.IsCompressed());
+    EXPECT_EQ(DiskBackendType::STREAM, dm.GetBackendType());
+    dm.WritePages(writes);
+    dm.ShutDown();
+  }
+  // Scenario: the pages take less than half of their size on disk.
+  EXPECT_LT(GetFileSize("test.db"), num_pages * PAGE_SIZE / 2);
+
+  auto dm = DiskManager({"test.db"}, 0, DiskBackendType::STREAM, true);
+  std::vector<std::vector<char>> bufs(4, std::vector<char>(PAGE_SIZE));
+  dm.ReadPages(EXTENT_SIZE - 2, {bufs[0].data(), bufs[1].data(), bufs[2].data(), bufs[3].data()});
+  for (page_id_t i = 0; i < 4; i++) {
+    EXPECT_EQ(pages[EXTENT_SIZE - 2 + i], bufs[i]);
+  }
+  EXPECT_TRUE(dm.ReadPageAsync(7, bufs[0].data()).get());
+  EXPECT_EQ(pages[7], bufs[0]);
+  EXPECT_EQ(num_pages, dm.AllocatePage());
+  EXPECT_EQ(0, dm.ScrubPages());
+  EXPECT_EQ(0, dm.GetNumCorruptPages());
+  dm.ShutDown();
+}
+
+}  // namespace bustub
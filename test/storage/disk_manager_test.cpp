@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -24,12 +28,16 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.crc");
+    remove("test.fsm");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.crc");
+    remove("test.fsm");
   };
 };
 
@@ -55,6 +63,166 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReadPagesTest) {
+  char buf[3][PAGE_SIZE];
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  for (page_id_t page_id = 0; page_id < 2; page_id++) {
+    snprintf(data, sizeof(data), "page %d", page_id);
+    dm.WritePage(page_id, data);
+  }
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPages(0, {buf[0], buf[1], buf[2]});
+  EXPECT_EQ(std::string("page 0"), buf[0]);
+  EXPECT_EQ(std::string("page 1"), buf[1]);
+  // Pages past the end of the file read as zeros.
+  std::memset(data, 0, sizeof(data));
+  EXPECT_EQ(std::memcmp(buf[2], data, PAGE_SIZE), 0);
+  EXPECT_EQ(3, dm.GetNumReads());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  for (auto backend_type : {DiskBackendType::STREAM, DiskBackendType::POSIX}) {
+    std::string db_file("test.db");
+    auto dm = DiskManager(db_file, backend_type);
+    // Scenario: a batch in any order, with runs of consecutive pages and gaps, writes every page.
+    std::vector<page_id_t> page_ids{7, 2, 3, 9, 1, 8};
+    std::vector<std::vector<char>> pages;
+    std::vector<std::pair<page_id_t, const char *>> writes;
+    for (page_id_t page_id : page_ids) {
+      pages.emplace_back(PAGE_SIZE);
+      snprintf(pages.back().data(), PAGE_SIZE, "page %d", page_id);
+    }
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      writes.emplace_back(page_ids[i], pages[i].data());
+    }
+    dm.WritePages(writes);
+    EXPECT_EQ(6, dm.GetNumWrites());
+
+    char buf[PAGE_SIZE] = {0};
+    for (page_id_t page_id : page_ids) {
+      dm.ReadPage(page_id, buf);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+    }
+    dm.ReadPage(5, buf);
+    EXPECT_EQ(0, buf[0]);
+
+    dm.ShutDown();
+    remove("test.db");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, TablespaceTest) {
+  std::vector<std::string> data_files{"test.db", "test_1.db", "test_2.db"};
+  for (auto backend_type : {DiskBackendType::STREAM, DiskBackendType::POSIX}) {
+    auto dm = DiskManager(data_files, 0, backend_type);
+    ASSERT_EQ(3, dm.GetNumDataFiles());
+    EXPECT_EQ("test_1.db", dm.GetDataFileName(1));
+
+    // Scenario: the pages are striped over the files, an extent at a time.
+    const page_id_t num_pages = 4 * EXTENT_SIZE;
+    std::vector<std::vector<char>> pages;
+    std::vector<std::pair<page_id_t, const char *>> writes;
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      pages.emplace_back(PAGE_SIZE);
+      snprintf(pages.back().data(), PAGE_SIZE, "page %d", page_id);
+    }
+    for (page_id_t page_id = 0; page_id < EXTENT_SIZE + 1; page_id++) {
+      dm.WritePage(page_id, pages[page_id].data());
+    }
+    for (page_id_t page_id = EXTENT_SIZE + 1; page_id < num_pages; page_id++) {
+      writes.emplace_back(page_id, pages[page_id].data());
+    }
+    dm.WritePages(writes);
+    EXPECT_EQ(2 * EXTENT_SIZE, dm.GetNumWrites(0));
+    EXPECT_EQ(EXTENT_SIZE, dm.GetNumWrites(1));
+    EXPECT_EQ(EXTENT_SIZE, dm.GetNumWrites(2));
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+    // Scenario: a run of pages that crosses a stripe reads from both files.
+    std::vector<std::vector<char>> bufs(4, std::vector<char>(PAGE_SIZE));
+    dm.ReadPages(2 * EXTENT_SIZE - 2, {bufs[0].data(), bufs[1].data(), bufs[2].data(), bufs[3].data()});
+    for (page_id_t i = 0; i < 4; i++) {
+      EXPECT_EQ("page " + std::to_string(2 * EXTENT_SIZE - 2 + i), std::string(bufs[i].data()));
+    }
+    EXPECT_EQ(2, dm.GetNumReads(1));
+    EXPECT_EQ(2, dm.GetNumReads(2));
+    dm.ShutDown();
+
+    // Scenario: the files are opened again with the same striping.
+    auto reopened = DiskManager(data_files, 0, backend_type);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id += 7) {
+      reopened.ReadPage(page_id, bufs[0].data());
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(bufs[0].data()));
+    }
+    EXPECT_EQ(num_pages, reopened.AllocatePage());
+    reopened.ShutDown();
+
+    for (const auto &data_file : data_files) {
+      remove(data_file.c_str());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, TablespaceLimitTest) {
+  std::vector<std::string> data_files{"test.db", "test_1.db"};
+  auto dm = DiskManager(data_files, EXTENT_SIZE + 1);
+
+  // Scenario: a file holds whole stripes up to its limit, no page is allocated past the limit of every file.
+  EXPECT_EQ(0, dm.AllocateExtent(EXTENT_SIZE));
+  EXPECT_EQ(EXTENT_SIZE, dm.AllocatePage());
+  EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateExtent(EXTENT_SIZE));
+  for (page_id_t page_id = EXTENT_SIZE + 1; page_id < 2 * EXTENT_SIZE; page_id++) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+  }
+  EXPECT_EQ(INVALID_PAGE_ID, dm.AllocatePage());
+
+  // Scenario: a deallocated page can be allocated again.
+  dm.DeallocatePage(3);
+  EXPECT_EQ(3, dm.AllocatePage());
+
+  dm.ShutDown();
+  remove("test_1.db");
+  remove("test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LargeFileTest) {
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  // A page past 2 GB into the data file, the file is sparse up to there.
+  const page_id_t page_id = static_cast<page_id_t>((int64_t{3} << 30) / PAGE_SIZE);
+  {
+    auto dm = DiskManager(db_file);
+    std::strncpy(data, "A page past 2 GB.", sizeof(data));
+    dm.WritePage(page_id, data);
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    ASSERT_TRUE(dm.MapDataFiles());
+    const char *mapped = dm.ReadMappedPage(page_id);
+    ASSERT_NE(nullptr, mapped);
+    EXPECT_EQ(std::memcmp(mapped, data, sizeof(buf)), 0);
+    dm.ShutDown();
+  }
+
+  // Scenario: without a bitmap file, every page below the last page of the file counts as allocated.
+  remove("test.fsm");
+  auto dm = DiskManager(db_file);
+  EXPECT_TRUE(dm.IsAllocated(page_id));
+  EXPECT_EQ(page_id + 1, dm.AllocatePage());
+  dm.ShutDown();
+  remove("test.fsm");
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
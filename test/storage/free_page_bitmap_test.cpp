@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_bitmap_test.cpp
+//
+// Identification: test/storage/free_page_bitmap_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/free_page_bitmap.h"
+
+namespace bustub {
+
+class FreePageBitmapTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  static void RemoveFiles() {
+    remove("test.db");
+    remove("test.log");
+    remove("test.fsm");
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(FreePageBitmapTest, ReuseTest) {
+  FreePageBitmap bitmap("", 0, false);
+  for (page_id_t page_id = 0; page_id < 200; page_id++) {
+    EXPECT_EQ(page_id, bitmap.Allocate());
+  }
+
+  // Scenario: the lowest freed page ids are allocated first, then the file grows again.
+  bitmap.Deallocate(150);
+  bitmap.Deallocate(3);
+  bitmap.Deallocate(70);
+  EXPECT_FALSE(bitmap.IsAllocated(70));
+  EXPECT_EQ(3, bitmap.Allocate());
+  EXPECT_EQ(70, bitmap.Allocate());
+  EXPECT_EQ(150, bitmap.Allocate());
+  EXPECT_EQ(200, bitmap.Allocate());
+
+  // Scenario: freeing a page id that is not allocated does nothing.
+  bitmap.Deallocate(500);
+  bitmap.Deallocate(INVALID_PAGE_ID);
+  EXPECT_EQ(201, bitmap.Allocate());
+
+  // Scenario: a stride only allocates the page ids of its residue class.
+  bitmap.Deallocate(5);
+  bitmap.Deallocate(6);
+  EXPECT_EQ(6, bitmap.Allocate(4, 2));
+  EXPECT_EQ(202, bitmap.Allocate(4, 2));
+  EXPECT_EQ(203, bitmap.Allocate(4, 3));
+  EXPECT_EQ(5, bitmap.Allocate(4, 1));
+  EXPECT_EQ(205, bitmap.Allocate(4, 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageBitmapTest, ExtentTest) {
+  FreePageBitmap bitmap("", 0, false);
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    EXPECT_EQ(page_id, bitmap.Allocate());
+  }
+
+  // Scenario: a run starts at a multiple of its size, the page ids skipped over stay free.
+  EXPECT_EQ(16, bitmap.AllocateExtent(16));
+  EXPECT_EQ(32, bitmap.AllocateExtent(16));
+  EXPECT_EQ(10, bitmap.Allocate());
+  for (page_id_t page_id = 16; page_id < 48; page_id++) {
+    EXPECT_TRUE(bitmap.IsAllocated(page_id));
+  }
+
+  // Scenario: a run is only reused once all of its page ids are free.
+  for (page_id_t page_id = 16; page_id < 31; page_id++) {
+    bitmap.Deallocate(page_id);
+  }
+  EXPECT_EQ(48, bitmap.AllocateExtent(16));
+  bitmap.Deallocate(31);
+  EXPECT_EQ(16, bitmap.AllocateExtent(16));
+  EXPECT_EQ(11, bitmap.Allocate());
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageBitmapTest, BufferPoolTest) {
+  DiskManager disk_manager("test.db");
+  BufferPoolManagerInstance bpm(10, &disk_manager);
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 5; i++) {
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    ASSERT_EQ(i, page_id);
+    ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+  }
+
+  // Scenario: a deleted page is handed out by the next new page.
+  ASSERT_TRUE(bpm.DeletePage(2));
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(2, page_id);
+  ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(5, page_id);
+  ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageBitmapTest, ParallelBufferPoolTest) {
+  DiskManager disk_manager("test.db");
+  ParallelBufferPoolManager bpm(3, 5, &disk_manager);
+
+  // Scenario: every instance reuses the deleted pages it owns.
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 9; i++) {
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+  }
+  ASSERT_TRUE(bpm.DeletePage(4));
+  ASSERT_TRUE(bpm.DeletePage(1));
+  // New pages go to the instances round-robin, so each instance allocates two of them.
+  std::set<page_id_t> page_ids;
+  for (int i = 0; i < 6; i++) {
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    page_ids.insert(page_id);
+    ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+  }
+  EXPECT_EQ((std::set<page_id_t>{1, 4, 9, 11, 12, 14}), page_ids);
+
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageBitmapTest, PersistenceTest) {
+  char data[PAGE_SIZE] = {0};
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    ASSERT_EQ(page_id, disk_manager->AllocatePage());
+    disk_manager->WritePage(page_id, data);
+  }
+  disk_manager->ShutDown();
+
+  // Scenario: without a bitmap file, every page of the db file is allocated.
+  disk_manager = std::make_unique<DiskManager>("test.db");
+  EXPECT_EQ(4, disk_manager->AllocatePage());
+  disk_manager->WritePage(4, data);
+  disk_manager->DeallocatePage(1);
+  disk_manager->ShutDown();
+
+  // Scenario: a deallocated page stays free after the db file is opened again.
+  disk_manager = std::make_unique<DiskManager>("test.db");
+  EXPECT_EQ(1, disk_manager->AllocatePage());
+  EXPECT_EQ(5, disk_manager->AllocatePage());
+  disk_manager->ShutDown();
+
+  // Scenario: so do the pages allocated after the bitmap file was created.
+  disk_manager = std::make_unique<DiskManager>("test.db");
+  EXPECT_EQ(6, disk_manager->AllocatePage());
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring_disk_backend_test.cpp
+//
+// Identification: test/storage/io_uring_disk_backend_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "common/exception.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/io_uring_disk_backend.h"
+
+namespace bustub {
+
+class IoUringDiskBackendTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(IoUringDiskBackendTest, ReadWritePageTest) {
+  DiskManager dm("test.db", DiskBackendType::IO_URING);
+  if (dm.GetBackendType() != DiskBackendType::IO_URING) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Scenario: a read past the end of the file reads zeros.
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(0, buf[PAGE_SIZE - 1]);
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // Scenario: many asynchronous requests in flight at once, more than the queue depth, all complete.
+  const int num_pages = 4 * IO_URING_QUEUE_DEPTH;
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<std::future<bool>> requests;
+  for (int i = 0; i < num_pages; i++) {
+    snprintf(pages[i].data(), PAGE_SIZE, "page %d", i);
+    requests.push_back(dm.WritePageAsync(i, pages[i].data()));
+  }
+  for (auto &request : requests) {
+    EXPECT_TRUE(request.get());
+  }
+  requests.clear();
+  for (int i = 0; i < num_pages; i++) {
+    std::memset(pages[i].data(), 0, PAGE_SIZE);
+    requests.push_back(dm.ReadPageAsync(i, pages[i].data()));
+  }
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_TRUE(requests[i].get());
+    EXPECT_EQ("page " + std::to_string(i), std::string(pages[i].data()));
+  }
+  EXPECT_EQ(num_pages + 1, dm.GetNumWrites());
+
+  // Scenario: a run of pages is read concurrently.
+  std::vector<char *> run{pages[0].data(), pages[1].data(), pages[2].data()};
+  dm.ReadPages(10, run);
+  EXPECT_EQ("page 12", std::string(pages[2].data()));
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(IoUringDiskBackendTest, PartialPageTest) {
+  int fd = open("test.db", O_RDWR | O_CREAT, 0644);
+  ASSERT_GE(fd, 0);
+  // The file ends half way through page 1.
+  std::vector<char> contents(PAGE_SIZE + PAGE_SIZE / 2, 'x');
+  ASSERT_EQ(static_cast<ssize_t>(contents.size()), pwrite(fd, contents.data(), contents.size(), 0));
+  std::unique_ptr<IoUringDiskBackend> backend;
+  try {
+    backend = std::make_unique<IoUringDiskBackend>(fd);
+  } catch (Exception &e) {
+    close(fd);
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  auto read_page = [&](page_id_t page_id, char *data) {
+    DiskRequest request{false, page_id, data, {}};
+    auto future = request.callback_.get_future();
+    backend->Schedule(std::move(request));
+    return future.get();
+  };
+  char buf[PAGE_SIZE];
+
+  // Scenario: a whole page inside the file is read as it is.
+  std::memset(buf, 1, sizeof(buf));
+  EXPECT_TRUE(read_page(0, buf));
+  EXPECT_EQ('x', buf[0]);
+  EXPECT_EQ('x', buf[PAGE_SIZE - 1]);
+
+  // Scenario: the part of a page inside the file is read, only the part past its end reads as zeros.
+  std::memset(buf, 1, sizeof(buf));
+  EXPECT_TRUE(read_page(1, buf));
+  EXPECT_EQ('x', buf[0]);
+  EXPECT_EQ('x', buf[PAGE_SIZE / 2 - 1]);
+  EXPECT_EQ(0, buf[PAGE_SIZE / 2]);
+  EXPECT_EQ(0, buf[PAGE_SIZE - 1]);
+
+  // Scenario: a page wholly past the end of the file reads as zeros.
+  std::memset(buf, 1, sizeof(buf));
+  EXPECT_TRUE(read_page(2, buf));
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(0, buf[PAGE_SIZE - 1]);
+
+  backend.reset();
+  close(fd);
+}
+
+// NOLINTNEXTLINE
+TEST_F(IoUringDiskBackendTest, BufferPoolTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db", DiskBackendType::IO_URING);
+  if (disk_manager->GetBackendType() != DiskBackendType::IO_URING) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  const size_t buffer_pool_size = 16;
+  {
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+    // Scenario: pages written from and read into the registered frames survive eviction and a flush of the pool.
+    for (int i = 0; i < 4 * static_cast<int>(buffer_pool_size); i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    bpm->FlushAllPages();
+    for (page_id_t page_id = 0; page_id < 4 * static_cast<int>(buffer_pool_size); page_id++) {
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+
+    // Scenario: a batch fetch reads its misses through the ring.
+    std::vector<page_id_t> page_ids{0, 1, 2, 3, 5, 8};
+    std::vector<Page *> pages;
+    EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids, &pages));
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+  }
+
+  // Scenario: a new buffer pool over the same file sees the flushed pages.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  Page *page = bpm->FetchPage(20);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 20", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(20, false));
+  bpm.reset();
+
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
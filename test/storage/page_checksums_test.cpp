@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_checksums_test.cpp
+//
+// Identification: test/storage/page_checksums_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/util/checksum_util.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/page_checksums.h"
+
+namespace bustub {
+
+class PageChecksumsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  static void RemoveFiles() {
+    remove("test.db");
+    remove("test.log");
+    remove("test.fsm");
+    remove("test.crc");
+  }
+
+  /** Overwrite a byte of a page in the database file, behind the back of the disk manager. */
+  static void CorruptPage(page_id_t page_id) {
+    std::fstream io("test.db", std::ios::binary | std::ios::in | std::ios::out);
+    io.seekp(static_cast<std::streamoff>(page_id) * PAGE_SIZE + 100);
+    io.put('X');
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(PageChecksumsTest, Crc32cTest) {
+  std::string check("123456789");
+  EXPECT_EQ(0xE3069283, ChecksumUtil::Crc32c(check.data(), check.size()));
+  // A checksum can be extended piece by piece.
+  uint32_t crc = ChecksumUtil::Crc32c(check.data(), 4);
+  EXPECT_EQ(0xE3069283, ChecksumUtil::Crc32c(check.data() + 4, check.size() - 4, crc));
+
+  // Every length and alignment gives the same checksum as the checksum of a copy.
+  std::vector<char> data(PAGE_SIZE);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * 31 + 7);
+  }
+  for (size_t offset = 0; offset < 9; offset++) {
+    std::vector<char> copy(data.begin() + offset, data.end());
+    EXPECT_EQ(ChecksumUtil::Crc32c(copy.data(), copy.size()),
+              ChecksumUtil::Crc32c(data.data() + offset, data.size() - offset));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageChecksumsTest, VerifyTest) {
+  PageChecksums checksums("test.crc", true);
+  std::vector<char> data(PAGE_SIZE, 0);
+  // Scenario: a page without a checksum is not verified.
+  EXPECT_TRUE(checksums.Verify(3, data.data()));
+
+  std::strncpy(data.data(), "page 3", PAGE_SIZE);
+  checksums.Update(3, data.data());
+  EXPECT_TRUE(checksums.Verify(3, data.data()));
+  data[PAGE_SIZE - 1] = 1;
+  EXPECT_FALSE(checksums.Verify(3, data.data()));
+  checksums.Close();
+
+  // Scenario: the checksums are kept in the checksum file.
+  PageChecksums reopened("test.crc", false);
+  EXPECT_FALSE(reopened.Verify(3, data.data()));
+  data[PAGE_SIZE - 1] = 0;
+  EXPECT_TRUE(reopened.Verify(3, data.data()));
+  reopened.Close();
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageChecksumsTest, DiskManagerTest) {
+  for (auto backend_type : {DiskBackendType::STREAM, DiskBackendType::POSIX}) {
+    char data[PAGE_SIZE] = {0};
+    char buf[PAGE_SIZE] = {0};
+    {
+      auto dm = DiskManager("test.db", backend_type);
+      for (page_id_t page_id = 0; page_id < 4; page_id++) {
+        snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+      }
+      dm.ShutDown();
+    }
+    CorruptPage(2);
+
+    auto dm = DiskManager("test.db", backend_type);
+    // Scenario: an intact page is read without complaint.
+    dm.ReadPage(1, buf);
+    EXPECT_EQ(0, dm.GetNumCorruptPages());
+    EXPECT_TRUE(dm.ReadPageAsync(1, buf).get());
+
+    // Scenario: a corrupt page is detected when it is read.
+    EXPECT_FALSE(dm.ReadPageAsync(2, buf).get());
+    EXPECT_EQ(1, dm.GetNumCorruptPages());
+    dm.ReadPages(1, {buf, data});
+    EXPECT_EQ(2, dm.GetNumCorruptPages());
+
+    // Scenario: the scrubber finds the corrupt page without a read, until the page is written again.
+    EXPECT_EQ(1, dm.ScrubPages());
+    EXPECT_EQ(3, dm.GetNumCorruptPages());
+    dm.WritePage(2, data);
+    EXPECT_EQ(0, dm.ScrubPages());
+    dm.ShutDown();
+    RemoveFiles();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageChecksumsTest, ScrubberTest) {
+  char data[PAGE_SIZE] = {0};
+  auto dm = DiskManager("test.db");
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (page_id_t page_id = 0; page_id < 2 * EXTENT_SIZE; page_id++) {
+    pages.emplace_back(page_id, data);
+  }
+  dm.WritePages(pages);
+  CorruptPage(EXTENT_SIZE + 1);
+
+  // Scenario: the scrubber thread scrubs in the background, and stops when asked.
+  dm.RunScrubber(std::chrono::milliseconds(1));
+  while (dm.GetNumCorruptPages() == 0) {
+    std::this_thread::yield();
+  }
+  dm.StopScrubber();
+  int num_corrupt_pages = dm.GetNumCorruptPages();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(num_corrupt_pages, dm.GetNumCorruptPages());
+  dm.ShutDown();
+}
+
+}  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posix_disk_backend_test.cpp
+//
+// Identification: test/storage/posix_disk_backend_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class PosixDiskBackendTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(PosixDiskBackendTest, ReadWritePageTest) {
+  DiskManager dm("test.db", DiskBackendType::POSIX);
+  EXPECT_EQ(DiskBackendType::POSIX, dm.GetBackendType());
+
+  // Scenario: buffers that are not page-aligned are read and written through a bounce buffer.
+  char buf[PAGE_SIZE + 1] = {0};
+  char data[PAGE_SIZE + 1] = {0};
+  std::strncpy(data + 1, "A test string.", PAGE_SIZE);
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(2, buf + 1);  // past the end of the file
+  EXPECT_EQ(0, buf[1]);
+  EXPECT_EQ(0, buf[PAGE_SIZE]);
+
+  dm.WritePage(0, data + 1);
+  dm.ReadPage(0, buf + 1);
+  EXPECT_EQ(std::memcmp(buf + 1, data + 1, PAGE_SIZE), 0);
+  dm.WritePage(5, data + 1);
+  std::memset(buf, 0, sizeof(buf));
+  dm.ReadPage(5, buf + 1);
+  EXPECT_EQ(std::memcmp(buf + 1, data + 1, PAGE_SIZE), 0);
+
+  // Scenario: threads read and write different pages at the same time.
+  const int num_threads = 4;
+  const int pages_per_thread = 32;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid] {
+      std::vector<char> page(PAGE_SIZE);
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = 10 + tid * pages_per_thread + i;
+        snprintf(page.data(), PAGE_SIZE, "page %d", page_id);
+        dm.WritePage(page_id, page.data());
+      }
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = 10 + tid * pages_per_thread + i;
+        dm.ReadPage(page_id, page.data());
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(page.data()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(2 + num_threads * pages_per_thread, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(PosixDiskBackendTest, BufferPoolTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db", DiskBackendType::POSIX);
+  const size_t buffer_pool_size = 16;
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+
+  // Scenario: the page-aligned frames are read and written directly, and pages survive eviction.
+  for (int i = 0; i < 4 * static_cast<int>(buffer_pool_size); i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id = 0; page_id < 4 * static_cast<int>(buffer_pool_size); page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a flush writes the resident pages, which are consecutive and page-aligned, in runs.
+  for (page_id_t page_id = 48; page_id < 4 * static_cast<int>(buffer_pool_size); page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "flushed %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  int writes_before = disk_manager->GetNumWrites();
+  bpm->FlushAllPages();
+  EXPECT_EQ(writes_before + static_cast<int>(buffer_pool_size), disk_manager->GetNumWrites());
+  std::vector<char> buf(PAGE_SIZE);
+  for (page_id_t page_id = 48; page_id < 4 * static_cast<int>(buffer_pool_size); page_id++) {
+    disk_manager->ReadPage(page_id, buf.data());
+    EXPECT_EQ("flushed " + std::to_string(page_id), std::string(buf.data()));
+  }
+  bpm.reset();
+
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
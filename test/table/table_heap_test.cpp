@@ -0,0 +1,666 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class TableHeapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    RemoveFiles();
+    disk_manager_ = std::make_unique<DiskManager>("test.db");
+    std::vector<Column> columns{Column{"a", TypeId::VARCHAR, 500}};
+    schema_ = std::make_unique<Schema>(columns);
+    txn_ = std::make_unique<Transaction>(0);
+  }
+
+  void TearDown() override {
+    disk_manager_->ShutDown();
+    RemoveFiles();
+  }
+
+  static void RemoveFiles() {
+    remove("test.db");
+    remove("test.log");
+    remove("test.fsm");
+  }
+
+  /** A page holds fewer than this many tuples of MakeTuple. */
+  static constexpr int TUPLES_PER_PAGE = PAGE_SIZE / 512;
+
+  /** @return a tuple of about 500 bytes, so that a page holds fewer than TUPLES_PER_PAGE of them */
+  Tuple MakeTuple() {
+    std::vector<Value> values{ValueFactory::GetVarcharValue(std::string(490, 'x'))};
+    return Tuple{values, schema_.get()};
+  }
+
+  /** @return the page ids of a table heap, in the order of its page chain */
+  static std::vector<page_id_t> GetPageIds(BufferPoolManager *bpm, TableHeap *table) {
+    std::vector<page_id_t> page_ids;
+    for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+      page_ids.push_back(page_id);
+      auto guard = bpm->FetchPageRead(page_id);
+      page_id = reinterpret_cast<TablePage *>(guard.GetPage())->GetNextPageId();
+    }
+    return page_ids;
+  }
+
+  /** Result of a scan from a cold buffer pool. */
+  struct ColdScan {
+    size_t num_tuples_{0};
+    size_t num_reads_{0};
+    std::chrono::microseconds elapsed_{0};
+  };
+
+  /**
+   * Load a table of small rows, then scan it from a cold buffer pool.
+   * @param num_tuples the number of rows to load
+   * @param[out] num_pages the number of pages of the table
+   * @return what the scan saw and what it cost
+   */
+  ColdScan LoadAndScan(int num_tuples, size_t *num_pages) {
+    std::vector<Column> columns{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}};
+    Schema schema(columns);
+    page_id_t first_page_id;
+    page_id_t free_space_map_page_id;
+    {
+      BufferPoolManagerInstance bpm(64, disk_manager_.get());
+      TableHeap table(&bpm, nullptr, nullptr, txn_.get());
+      RID rid;
+      for (int i = 0; i < num_tuples; i++) {
+        std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                                  ValueFactory::GetVarcharValue("name" + std::to_string(i % 1000))};
+        EXPECT_TRUE(table.InsertTuple(Tuple{values, &schema}, &rid, txn_.get()));
+      }
+      first_page_id = table.GetFirstPageId();
+      free_space_map_page_id = table.GetFreeSpaceMapPageId();
+      *num_pages = GetPageIds(&bpm, &table).size();
+      bpm.FlushAllPages();
+    }
+
+    BufferPoolManagerInstance bpm(64, disk_manager_.get());
+    TableHeap table(&bpm, nullptr, nullptr, first_page_id, free_space_map_page_id);
+    ColdScan scan;
+    int num_reads = disk_manager_->GetNumReads();
+    auto start = std::chrono::steady_clock::now();
+    for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+      scan.num_tuples_++;
+    }
+    scan.elapsed_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    scan.num_reads_ = disk_manager_->GetNumReads() - num_reads;
+    return scan;
+  }
+
+  /** Delete a tuple and commit the delete. */
+  void DeleteTuple(TableHeap *table, const RID &rid) {
+    ASSERT_TRUE(table->MarkDelete(rid, txn_.get()));
+    table->ApplyDelete(rid, txn_.get());
+  }
+
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<Schema> schema_;
+  std::unique_ptr<Transaction> txn_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ExtentTest) {
+  BufferPoolManagerInstance bpm(20, disk_manager_.get());
+
+  // Scenario: two tables that grow at the same time each get their own run of contiguous pages.
+  TableHeap table1(&bpm, nullptr, nullptr, txn_.get());
+  TableHeap table2(&bpm, nullptr, nullptr, txn_.get());
+  Tuple tuple = MakeTuple();
+  RID rid;
+  for (int i = 0; i < TUPLES_PER_PAGE * (EXTENT_SIZE + 4); i++) {
+    ASSERT_TRUE(table1.InsertTuple(tuple, &rid, txn_.get()));
+    ASSERT_TRUE(table2.InsertTuple(tuple, &rid, txn_.get()));
+  }
+  auto page_ids1 = GetPageIds(&bpm, &table1);
+  auto page_ids2 = GetPageIds(&bpm, &table2);
+  ASSERT_GT(page_ids1.size(), static_cast<size_t>(EXTENT_SIZE));
+  ASSERT_EQ(page_ids1.size(), page_ids2.size());
+  for (size_t i = 0; i < EXTENT_SIZE; i++) {
+    EXPECT_EQ(page_ids1[0] + static_cast<page_id_t>(i), page_ids1[i]);
+    EXPECT_EQ(page_ids2[0] + static_cast<page_id_t>(i), page_ids2[i]);
+  }
+  EXPECT_NE(page_ids1[0], page_ids2[0]);
+
+  // Scenario: once its run is used up, a table continues in a new run.
+  EXPECT_EQ(0, page_ids1[EXTENT_SIZE] % EXTENT_SIZE);
+  EXPECT_EQ(page_ids1[EXTENT_SIZE] + 1, page_ids1[EXTENT_SIZE + 1]);
+
+  // Scenario: a page allocated on its own does not land in a run.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+  for (auto *page_ids : {&page_ids1, &page_ids2}) {
+    for (size_t i = 0; i < page_ids->size(); i += EXTENT_SIZE) {
+      EXPECT_TRUE(page_id < (*page_ids)[i] || page_id >= (*page_ids)[i] + EXTENT_SIZE);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ParallelExtentTest) {
+  ParallelBufferPoolManager bpm(4, 5, disk_manager_.get());
+
+  // Scenario: the pages of a run are created in the instances that own them.
+  TableHeap table(&bpm, nullptr, nullptr, txn_.get());
+  Tuple tuple = MakeTuple();
+  RID rid;
+  for (int i = 0; i < TUPLES_PER_PAGE * 10; i++) {
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn_.get()));
+  }
+  auto page_ids = GetPageIds(&bpm, &table);
+  ASSERT_GT(page_ids.size(), 8);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    EXPECT_EQ(page_ids[0] + static_cast<page_id_t>(i), page_ids[i]);
+  }
+
+  size_t num_tuples = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    num_tuples++;
+  }
+  EXPECT_EQ(TUPLES_PER_PAGE * 10, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, FreeSpaceMapTest) {
+  BufferPoolManagerInstance bpm(20, disk_manager_.get());
+  FreeSpaceMap map(&bpm);
+
+  // Scenario: the map spans several pages, a search finds the first table page with enough room.
+  const auto num_table_pages = static_cast<page_id_t>(FreeSpaceMapPage::CAPACITY * 2 + 10);
+  for (page_id_t page_id = 0; page_id < num_table_pages; page_id++) {
+    ASSERT_TRUE(map.Add(1000 + page_id, page_id == num_table_pages - 1 ? PAGE_SIZE / 2 : 0));
+  }
+  FreeSpaceMap::Entry entry;
+  ASSERT_TRUE(map.FindPage(100, &entry));
+  EXPECT_EQ(1000 + num_table_pages - 1, entry.table_page_id_);
+  EXPECT_FALSE(map.FindPage(PAGE_SIZE / 2 + FreeSpaceMapPage::CATEGORY_SIZE, &entry));
+
+  // Scenario: a page given free space before where the last search stopped is found again.
+  FreeSpaceMap::Entry early;
+  ASSERT_TRUE(map.FindEntry(1005, &early));
+  EXPECT_EQ(map.GetFirstPageId(), early.map_page_id_);
+  EXPECT_EQ(5, early.index_);
+  map.Update(early, PAGE_SIZE);
+  ASSERT_TRUE(map.FindPage(PAGE_SIZE / 2 + FreeSpaceMapPage::CATEGORY_SIZE, &entry));
+  EXPECT_EQ(1005, entry.table_page_id_);
+
+  // Scenario: a page that fills up is no longer found.
+  map.Update(entry, 0);
+  ASSERT_TRUE(map.FindPage(100, &entry));
+  EXPECT_EQ(1000 + num_table_pages - 1, entry.table_page_id_);
+
+  // Scenario: the map is opened again from its first page.
+  FreeSpaceMap reopened(&bpm, map.GetFirstPageId());
+  ASSERT_TRUE(reopened.FindPage(100, &entry));
+  EXPECT_EQ(1000 + num_table_pages - 1, entry.table_page_id_);
+  ASSERT_TRUE(reopened.Add(42, PAGE_SIZE));
+  ASSERT_TRUE(reopened.FindPage(PAGE_SIZE - FreeSpaceMapPage::CATEGORY_SIZE, &entry));
+  EXPECT_EQ(42, entry.table_page_id_);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, InsertFreeSpaceTest) {
+  BufferPoolManagerInstance bpm(20, disk_manager_.get());
+  TableHeap table(&bpm, nullptr, nullptr, txn_.get());
+  Tuple tuple = MakeTuple();
+  RID rid;
+  for (int i = 0; i < TUPLES_PER_PAGE * 10; i++) {
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn_.get()));
+  }
+  auto page_ids = GetPageIds(&bpm, &table);
+
+  // Scenario: small tuples fill the room left in the pages before the table grows.
+  std::vector<Column> columns{Column{"a", TypeId::INTEGER}};
+  Schema schema(columns);
+  Tuple small{std::vector<Value>{ValueFactory::GetIntegerValue(1)}, &schema};
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(table.InsertTuple(small, &rid, txn_.get()));
+  }
+  EXPECT_EQ(page_ids.size(), GetPageIds(&bpm, &table).size());
+
+  // Scenario: a table opened without its free space map builds it from its pages, a search starts at the first page,
+  // and the table grows at its end.
+  TableHeap reopened(&bpm, nullptr, nullptr, table.GetFirstPageId());
+  ASSERT_TRUE(reopened.InsertTuple(small, &rid, txn_.get()));
+  EXPECT_EQ(page_ids[0], rid.GetPageId());
+  for (int i = 0; i < TUPLES_PER_PAGE; i++) {
+    ASSERT_TRUE(reopened.InsertTuple(tuple, &rid, txn_.get()));
+  }
+  auto new_page_ids = GetPageIds(&bpm, &reopened);
+  ASSERT_EQ(page_ids.size() + 1, new_page_ids.size());
+  EXPECT_EQ(new_page_ids.back(), rid.GetPageId());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ConcurrentInsertTest) {
+  const int num_threads = 4;
+  const int num_tuples_per_thread = TUPLES_PER_PAGE * 50;
+  BufferPoolManagerInstance bpm(50, disk_manager_.get());
+  TableHeap table(&bpm, nullptr, nullptr, txn_.get());
+  Tuple tuple = MakeTuple();
+
+  // Scenario: every thread inserts into pages of its own, and every tuple ends up in the table.
+  std::vector<std::set<page_id_t>> page_ids(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      Transaction txn(tid + 1);
+      RID rid;
+      for (int i = 0; i < num_tuples_per_thread; i++) {
+        ASSERT_TRUE(table.InsertTuple(tuple, &rid, &txn));
+        page_ids[tid].insert(rid.GetPageId());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int tid = 0; tid < num_threads; tid++) {
+    for (int other = tid + 1; other < num_threads; other++) {
+      for (auto page_id : page_ids[tid]) {
+        EXPECT_EQ(0, page_ids[other].count(page_id));
+      }
+    }
+  }
+  size_t num_scanned = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    num_scanned++;
+  }
+  EXPECT_EQ(num_threads * num_tuples_per_thread, num_scanned);
+  auto chain = GetPageIds(&bpm, &table);
+  EXPECT_EQ(chain.size(), std::set<page_id_t>(chain.begin(), chain.end()).size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, InsertCostTest) {
+  // Load a table much larger than the buffer pool through InsertTuple. Each insert goes straight to a page with room,
+  // so the pages that filled up and were evicted are never read back and an insert costs the same however large the
+  // table grows.
+  const int num_tuples = 20000;
+  std::vector<Column> columns{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}};
+  Schema schema(columns);
+  BufferPoolManagerInstance bpm(16, disk_manager_.get());
+  TableHeap table(&bpm, nullptr, nullptr, txn_.get());
+  RID rid;
+  int num_reads = disk_manager_->GetNumReads();
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue("name" + std::to_string(i % 1000))};
+    ASSERT_TRUE(table.InsertTuple(Tuple{values, &schema}, &rid, txn_.get()));
+  }
+  EXPECT_EQ(num_reads, disk_manager_->GetNumReads());
+  EXPECT_EQ(num_tuples, txn_->GetWriteSet()->size());
+  EXPECT_GT(GetPageIds(&bpm, &table).size(), 4 * bpm.GetPoolSize());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, BulkLoadTest) {
+  BufferPoolManagerInstance bpm(20, disk_manager_.get());
+  TableHeap table(&bpm, nullptr, nullptr, txn_.get());
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(MakeTuple(), &rid, txn_.get()));
+  txn_->GetWriteSet()->clear();
+
+  // Scenario: the tuples are loaded into new pages at the end of the table, without write set entries.
+  const int num_tuples = TUPLES_PER_PAGE * 10 + 3;
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<Value> values{ValueFactory::GetVarcharValue(std::string(490, 'a' + i % 26))};
+    tuples.emplace_back(values, schema_.get());
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(table.BulkLoad(tuples.begin(), tuples.end(), txn_.get(), &rids));
+  ASSERT_EQ(num_tuples, rids.size());
+  EXPECT_TRUE(txn_->GetWriteSet()->empty());
+  auto page_ids = GetPageIds(&bpm, &table);
+  EXPECT_EQ(page_ids[1], rids.front().GetPageId());
+  EXPECT_EQ(page_ids.back(), rids.back().GetPageId());
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(table.GetTuple(rids[i], &tuple, txn_.get()));
+    EXPECT_EQ(tuples[i].GetValue(schema_.get(), 0).ToString(), tuple.GetValue(schema_.get(), 0).ToString());
+  }
+  size_t num_scanned = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    num_scanned++;
+  }
+  EXPECT_EQ(num_tuples + 1, num_scanned);
+
+  // Scenario: the room left in the last loaded page is in the free space map, inserts use it once the first page is
+  // full.
+  do {
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(), &rid, txn_.get()));
+  } while (rid.GetPageId() == page_ids[0]);
+  EXPECT_EQ(page_ids.back(), rid.GetPageId());
+
+  // Scenario: a tuple too large for a page fails the load.
+  std::vector<Column> columns{Column{"a", TypeId::VARCHAR, PAGE_SIZE}};
+  Schema schema(columns);
+  std::vector<Tuple> large{Tuple{std::vector<Value>{ValueFactory::GetVarcharValue(std::string(PAGE_SIZE, 'x'))},
+                                 &schema}};
+  EXPECT_FALSE(table.BulkLoad(large.begin(), large.end(), txn_.get()));
+  EXPECT_EQ(TransactionState::ABORTED, txn_->GetState());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, BulkLoadPackingTest) {
+  // Load the same rows through InsertTuple and through BulkLoad. The load fills the pages as tightly as the inserts,
+  // without the write set entry each insert adds.
+  const int num_tuples = 20000;
+  std::vector<Column> columns{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}};
+  Schema schema(columns);
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue("name" + std::to_string(i % 1000))};
+    tuples.emplace_back(values, &schema);
+  }
+  BufferPoolManagerInstance bpm(64, disk_manager_.get());
+
+  TableHeap inserted(&bpm, nullptr, nullptr, txn_.get());
+  RID rid;
+  for (const auto &tuple : tuples) {
+    ASSERT_TRUE(inserted.InsertTuple(tuple, &rid, txn_.get()));
+  }
+  EXPECT_EQ(num_tuples, txn_->GetWriteSet()->size());
+
+  TableHeap loaded(&bpm, nullptr, nullptr, txn_.get());
+  ASSERT_TRUE(loaded.BulkLoad(tuples.begin(), tuples.end(), txn_.get()));
+  EXPECT_EQ(num_tuples, txn_->GetWriteSet()->size());
+  // The load leaves the first page, created with the table, empty.
+  EXPECT_EQ(GetPageIds(&bpm, &inserted).size() + 1, GetPageIds(&bpm, &loaded).size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, VacuumTest) {
+  BufferPoolManagerInstance bpm(20, disk_manager_.get());
+  LockManager lock_manager;
+  TableHeap table(&bpm, &lock_manager, nullptr, txn_.get());
+  Tuple tuple = MakeTuple();
+  std::vector<RID> rids(TUPLES_PER_PAGE * 6);
+  for (auto &rid : rids) {
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn_.get()));
+  }
+  auto page_ids = GetPageIds(&bpm, &table);
+  ASSERT_GE(page_ids.size(), 7);
+
+  // Delete every tuple of the second and third page, the last two tuples of the first page, and the first tuple of the
+  // fifth page. Mark a tuple of the fourth page deleted without committing the delete.
+  std::vector<RID> first_page_rids;
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() == page_ids[0]) {
+      first_page_rids.push_back(rid);
+    }
+  }
+  size_t num_deleted = 0;
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() == page_ids[1] || rid.GetPageId() == page_ids[2] || rid == first_page_rids.back() ||
+        rid == first_page_rids[first_page_rids.size() - 2] || rid == RID(page_ids[4], 0)) {
+      DeleteTuple(&table, rid);
+      num_deleted++;
+    }
+  }
+  ASSERT_TRUE(table.MarkDelete(RID(page_ids[3], 0), txn_.get()));
+
+  // Scenario: the empty pages are unlinked and deallocated, the empty slots at the end of a page are dropped.
+  EXPECT_EQ(2 * PAGE_SIZE + 2 * 8, table.Vacuum(txn_.get()));
+  auto vacuumed_page_ids = GetPageIds(&bpm, &table);
+  ASSERT_EQ(page_ids.size() - 2, vacuumed_page_ids.size());
+  EXPECT_EQ(page_ids[0], vacuumed_page_ids[0]);
+  EXPECT_EQ(page_ids[3], vacuumed_page_ids[1]);
+  size_t num_scanned = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    num_scanned++;
+  }
+  EXPECT_EQ(rids.size() - num_deleted - 1, num_scanned);
+  Tuple read;
+  EXPECT_TRUE(table.GetTuple(first_page_rids[0], &read, txn_.get()));
+  table.RollbackDelete(RID(page_ids[3], 0), txn_.get());
+  EXPECT_TRUE(table.GetTuple(RID(page_ids[3], 0), &read, txn_.get()));
+
+  // Scenario: a second vacuum finds nothing to reclaim.
+  EXPECT_EQ(0, table.Vacuum(txn_.get()));
+
+  // Scenario: the room made by the deletes is found by inserts once the target page of this thread, the last one, is
+  // full.
+  RID rid;
+  do {
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn_.get()));
+  } while (rid.GetPageId() == page_ids.back() || rid.GetPageId() == page_ids[0]);
+  EXPECT_EQ(RID(page_ids[4], 0), rid);
+  EXPECT_EQ(page_ids.size() - 2, GetPageIds(&bpm, &table).size());
+
+  // Scenario: no page is reclaimed while an iterator is open, the empty page is only compacted.
+  size_t num_slots = 0;
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() == page_ids[5]) {
+      DeleteTuple(&table, rid);
+      num_slots++;
+    }
+  }
+  {
+    auto iter = table.Begin(txn_.get());
+    EXPECT_EQ(num_slots * 8, table.Vacuum(txn_.get()));
+    EXPECT_EQ(page_ids.size() - 2, GetPageIds(&bpm, &table).size());
+  }
+  EXPECT_EQ(PAGE_SIZE, table.Vacuum(txn_.get()));
+  EXPECT_EQ(page_ids.size() - 3, GetPageIds(&bpm, &table).size());
+
+  // Scenario: the reclaimed pages are allocated again.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(page_ids[1], page_id);
+  ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ConcurrentVacuumTest) {
+  const int num_threads = 2;
+  const int num_tuples_per_thread = TUPLES_PER_PAGE * 30;
+  BufferPoolManagerInstance bpm(50, disk_manager_.get());
+  LockManager lock_manager;
+  TableHeap table(&bpm, &lock_manager, nullptr, txn_.get());
+  Tuple tuple = MakeTuple();
+
+  // Scenario: pages are emptied and reclaimed while other threads insert.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      Transaction txn(tid + 1);
+      RID rid;
+      for (int i = 0; i < num_tuples_per_thread; i++) {
+        ASSERT_TRUE(table.InsertTuple(tuple, &rid, &txn));
+      }
+    });
+  }
+  // Scenario: scans start while empty pages are reclaimed.
+  std::atomic<bool> vacuumed{false};
+  threads.emplace_back([&]() {
+    Transaction txn(num_threads + 1);
+    while (!vacuumed) {
+      auto iter = table.Begin(&txn);
+      // The scan starts on a tuple of the table, unless the vacuuming thread deleted it in between.
+      if (iter != table.End() && iter->GetLength() != 0) {
+        EXPECT_EQ(tuple.GetLength(), iter->GetLength());
+      }
+    }
+  });
+  size_t num_reclaimed_bytes = 0;
+  for (int round = 0; round < 10; round++) {
+    std::vector<RID> rids(TUPLES_PER_PAGE * 3);
+    for (auto &rid : rids) {
+      ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn_.get()));
+    }
+    for (const auto &rid : rids) {
+      DeleteTuple(&table, rid);
+    }
+    num_reclaimed_bytes += table.Vacuum(txn_.get());
+  }
+  vacuumed = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GT(num_reclaimed_bytes, 0);
+
+  size_t num_scanned = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    num_scanned++;
+  }
+  EXPECT_EQ(num_threads * num_tuples_per_thread, num_scanned);
+  auto chain = GetPageIds(&bpm, &table);
+  EXPECT_EQ(chain.size(), std::set<page_id_t>(chain.begin(), chain.end()).size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, OverflowTest) {
+  std::vector<Column> columns{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}};
+  Schema schema(columns);
+  const int num_tuples = 20;
+  // Each large value takes a chain of three overflow pages.
+  const uint32_t value_size = 2 * OverflowPage::CAPACITY + 100;
+  const int num_overflow_pages = 3;
+  auto make_tuple = [&schema](int i, uint32_t size) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue(std::string(size, static_cast<char>('a' + i % 26)))};
+    return Tuple{values, &schema};
+  };
+  auto count_allocated_pages = [this]() {
+    int num_pages = 0;
+    for (page_id_t page_id = 0; page_id < 8 * EXTENT_SIZE; page_id++) {
+      num_pages += disk_manager_->IsAllocated(page_id) ? 1 : 0;
+    }
+    return num_pages;
+  };
+  page_id_t first_page_id;
+  page_id_t free_space_map_page_id;
+  size_t num_pages;
+  std::vector<RID> rids(num_tuples);
+  {
+    BufferPoolManagerInstance bpm(64, disk_manager_.get());
+    LockManager lock_manager;
+
+    // Scenario: a table that does not know the schema of its tuples rejects a tuple larger than a page.
+    TableHeap whole_table(&bpm, nullptr, nullptr, txn_.get());
+    RID rid;
+    EXPECT_FALSE(whole_table.InsertTuple(make_tuple(0, value_size), &rid, txn_.get()));
+    txn_->SetState(TransactionState::GROWING);
+
+    // Scenario: the large values are stored out of line and read back whole, a small value stays in its tuple.
+    TableHeap table(&bpm, &lock_manager, nullptr, txn_.get(), &schema);
+    for (int i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(table.InsertTuple(make_tuple(i, value_size), &rids[i], txn_.get()));
+    }
+    Tuple small_tuple = make_tuple(num_tuples, 100);
+    ASSERT_TRUE(table.InsertTuple(small_tuple, &rid, txn_.get()));
+    Tuple read;
+    ASSERT_TRUE(table.GetTuple(rid, &read, txn_.get()));
+    EXPECT_EQ(small_tuple.GetLength(), read.GetLength());
+    for (int i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(table.GetTuple(rids[i], &read, txn_.get()));
+      EXPECT_LT(read.GetLength(), PAGE_SIZE / 4);
+      EXPECT_EQ(i, read.GetValue(&schema, 0).GetAs<int32_t>());
+      EXPECT_EQ(std::string(value_size, static_cast<char>('a' + i % 26)), read.GetValue(&schema, 1).ToString());
+    }
+
+    // Scenario: a bulk load stores the large values out of line too.
+    std::vector<Tuple> tuples{make_tuple(num_tuples + 1, value_size)};
+    std::vector<RID> loaded_rids;
+    ASSERT_TRUE(table.BulkLoad(tuples.begin(), tuples.end(), txn_.get(), &loaded_rids));
+    ASSERT_TRUE(table.GetTuple(loaded_rids[0], &read, txn_.get()));
+    EXPECT_EQ(value_size, read.GetValue(&schema, 1).ToString().size());
+
+    // Scenario: a tuple with values stored out of line is updated through a delete and an insert.
+    EXPECT_FALSE(table.UpdateTuple(small_tuple, rids[0], txn_.get()));
+
+    // Scenario: the overflow pages of a deleted tuple are deallocated.
+    int num_allocated_pages = count_allocated_pages();
+    DeleteTuple(&table, loaded_rids[0]);
+    EXPECT_EQ(num_allocated_pages - num_overflow_pages, count_allocated_pages());
+
+    first_page_id = table.GetFirstPageId();
+    free_space_map_page_id = table.GetFreeSpaceMapPageId();
+    num_pages = GetPageIds(&bpm, &table).size();
+    bpm.FlushAllPages();
+  }
+
+  // Scenario: a scan reads the overflow pages of a value only when the value is accessed.
+  BufferPoolManagerInstance bpm(64, disk_manager_.get());
+  TableHeap table(&bpm, nullptr, nullptr, first_page_id, free_space_map_page_id, &schema);
+  int num_reads = disk_manager_->GetNumReads();
+  int sum = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    sum += iter->GetValue(&schema, 0).GetAs<int32_t>();
+  }
+  EXPECT_EQ((num_tuples + 1) * num_tuples / 2, sum);
+  EXPECT_EQ(num_pages, static_cast<size_t>(disk_manager_->GetNumReads() - num_reads));
+  num_reads = disk_manager_->GetNumReads();
+  size_t num_bytes = 0;
+  for (auto iter = table.Begin(txn_.get()); iter != table.End(); ++iter) {
+    num_bytes += iter->GetValue(&schema, 1).ToString().size();
+  }
+  EXPECT_EQ(num_tuples * value_size + 100, num_bytes);
+  EXPECT_LE(static_cast<size_t>(num_tuples * num_overflow_pages), disk_manager_->GetNumReads() - num_reads);
+
+  // Scenario: a value stored out of line cannot be read while every frame is pinned, and can be once one is free.
+  Tuple read;
+  ASSERT_TRUE(table.GetTuple(rids[1], &read, txn_.get()));
+  std::vector<BasicPageGuard> guards;
+  for (size_t i = 0; i < bpm.GetPoolSize(); i++) {
+    page_id_t page_id;
+    guards.push_back(bpm.NewPageGuarded(&page_id));
+    ASSERT_TRUE(guards.back().IsValid());
+  }
+  EXPECT_THROW(read.GetValue(&schema, 1), Exception);
+  guards.clear();
+  EXPECT_EQ(value_size, read.GetValue(&schema, 1).ToString().size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ColdScanTest) {
+  size_t num_pages;
+  ColdScan scan = LoadAndScan(10000, &num_pages);
+  EXPECT_EQ(10000, scan.num_tuples_);
+  // Every page is read once, larger pages need fewer reads for the same table.
+  EXPECT_EQ(num_pages, scan.num_reads_);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, DISABLED_ScanBenchmarkTest) {
+  // Build with each BUSTUB_PAGE_SIZE to compare the page sizes, e.g. with build_support/page_size_benchmark.sh.
+  size_t num_pages;
+  ColdScan scan = LoadAndScan(100000, &num_pages);
+  std::cout << "PAGE_SIZE " << PAGE_SIZE << ": " << num_pages << " pages, " << scan.num_reads_ << " page reads, "
+            << scan.elapsed_.count() << " us to scan " << scan.num_tuples_ << " tuples" << std::endl;
+}
+
+}  // namespace bustub